@@ -0,0 +1,176 @@
+#include "tetris.h"
+
+void board_from_game(GameInfo_t *game, Board_t *board) {
+  remove_figure(game);
+  board_from_field(game, board);
+  place_figure(game);
+}
+
+void board_from_field(GameInfo_t *game, Board_t *board) {
+  for (int row = 0; row < BOARD_HEIGHT; row++) {
+    uint8_t mask = 0;
+
+    for (int column = 0; column < BOARD_WIDTH; column++) {
+      if (game->field[row][column] != EMPTY_CELL) {
+        mask |= (uint8_t)(1u << column);
+      }
+    }
+
+    board->rows[row] = mask;
+  }
+}
+
+void shape_to_mask(int shape[SHAPE_SIZE][SHAPE_SIZE], uint8_t mask[]) {
+  for (int i = 0; i < SHAPE_SIZE; i++) {
+    mask[i] = 0;
+
+    for (int j = 0; j < SHAPE_SIZE; j++) {
+      if (shape[i][j] != SPACE) {
+        mask[i] |= (uint8_t)(1u << j);
+      }
+    }
+  }
+}
+
+void rotate_mask(const uint8_t mask[], uint8_t rotated[]) {
+  for (int j = 0; j < SHAPE_SIZE; j++) {
+    rotated[j] = 0;
+
+    for (int i = 0; i < SHAPE_SIZE; i++) {
+      if (mask[i] & (1u << j)) {
+        rotated[j] |= (uint8_t)(1u << (SHAPE_SIZE - i - 1));
+      }
+    }
+  }
+}
+
+bool board_fits(const Board_t *board, const uint8_t mask[], int x, int y) {
+  bool fits = (x > -SHAPE_SIZE && x < BOARD_WIDTH);
+
+  for (int i = 0; i < SHAPE_SIZE && fits; i++) {
+    if (mask[i] == 0) continue;
+
+    int row = y + i;
+    unsigned int shifted = shift_mask_row(mask[i], x);
+
+    if (row < 0 || row >= BOARD_HEIGHT || shifted > BOARD_FULL_ROW ||
+        (x < 0 && (mask[i] & ((1u << -x) - 1))) ||
+        (board->rows[row] & shifted)) {
+      fits = false;
+    }
+  }
+
+  return fits;
+}
+
+unsigned int shift_mask_row(uint8_t row, int x) {
+  return (x >= 0) ? (unsigned int)row << x : (unsigned int)row >> -x;
+}
+
+int board_drop(const Board_t *board, const uint8_t mask[], int x, int y) {
+  while (board_fits(board, mask, x, y + 1)) {
+    y++;
+  }
+
+  return y;
+}
+
+void board_place(Board_t *board, const uint8_t mask[], int x, int y) {
+  for (int i = 0; i < SHAPE_SIZE; i++) {
+    if (mask[i] != 0) {
+      board->rows[y + i] |= (uint8_t)shift_mask_row(mask[i], x);
+    }
+  }
+}
+
+int board_clear_lines(Board_t *board) {
+  int destination = LINES_NUMBER - 1;
+
+  for (int row = LINES_NUMBER - 1; row >= 0; row--) {
+    if (board->rows[row] != BOARD_FULL_ROW) {
+      board->rows[destination--] = board->rows[row];
+    }
+  }
+
+  int cleared = destination + 1;
+  for (; destination >= 0; destination--) {
+    board->rows[destination] = 0;
+  }
+
+  return cleared;
+}
+
+bool board_is_empty(const Board_t *board) {
+  bool empty = true;
+
+  for (int row = 0; row < LINES_NUMBER && empty; row++) {
+    empty = (board->rows[row] == 0);
+  }
+
+  return empty;
+}
+
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  uint64_t hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+
+  return hash ^ (hash >> 29);
+}
+
+int find_placements(const Board_t *board, const uint8_t shape[],
+                    Placement_t placements[]) {
+  int count = 0;
+  uint8_t mask[SHAPE_SIZE];
+  memcpy(mask, shape, SHAPE_SIZE);
+
+  for (int rotation = 0; rotation < SHAPE_SIZE; rotation++) {
+    if (rotation > 0) {
+      uint8_t rotated[SHAPE_SIZE];
+      rotate_mask(mask, rotated);
+      memcpy(mask, rotated, SHAPE_SIZE);
+    }
+
+    if (!board_fits(board, mask, HORISONTAL_FIELD_MIDDLE, 0)) break;
+
+    count = add_placements(board, mask, rotation, placements, count);
+  }
+
+  return count;
+}
+
+int add_placements(const Board_t *board, const uint8_t mask[], int rotation,
+                   Placement_t placements[], int count) {
+  int left = HORISONTAL_FIELD_MIDDLE;
+  int right = HORISONTAL_FIELD_MIDDLE;
+
+  while (board_fits(board, mask, left - 1, 0)) left--;
+  while (board_fits(board, mask, right + 1, 0)) right++;
+
+  for (int x = left; x <= right; x++) {
+    Placement_t placement = {rotation, x, board_drop(board, mask, x, 0), {0}};
+    memcpy(placement.mask, mask, SHAPE_SIZE);
+
+    if (!placement_is_known(placements, count, &placement)) {
+      placements[count++] = placement;
+    }
+  }
+
+  return count;
+}
+
+bool placement_is_known(const Placement_t placements[], int count,
+                        const Placement_t *placement) {
+  bool known = false;
+
+  for (int i = 0; i < count && !known; i++) {
+    known = placements[i].x == placement->x &&
+            placements[i].y == placement->y &&
+            memcmp(placements[i].mask, placement->mask, SHAPE_SIZE) == 0;
+  }
+
+  return known;
+}
@@ -0,0 +1,367 @@
+#include "tetris.h"
+
+OpeningBook_t opening_book = {0};
+
+int run_build_book(const char *path, int depth, int threads) {
+  BookKey_t *frontier = (BookKey_t *)calloc(LEN(figures), sizeof(BookKey_t));
+  BookEntry_t *book = NULL;
+  uint32_t count = LEN(figures);
+  uint32_t total = 0;
+
+  if (depth < 1) depth = 1;
+  if (depth > BOOK_MAX_DEPTH) depth = BOOK_MAX_DEPTH;
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads <= 0) threads = 1;
+
+  for (uint32_t i = 0; frontier != NULL && i < count; i++) {
+    frontier[i].current = (uint8_t)(i + 1);
+  }
+
+  bool built = (frontier != NULL);
+  for (int piece = 0; piece < depth && built; piece++) {
+    uint32_t states = count * LEN(figures);
+    BookLevel_t level = {frontier, count, NULL, NULL, 0};
+
+    BookEntry_t *grown = (BookEntry_t *)realloc(
+        book, (total + states) * sizeof(BookEntry_t));
+    if (grown != NULL) book = grown;
+
+    level.children = (BookKey_t *)malloc(states * sizeof(BookKey_t));
+    built = (grown != NULL && level.children != NULL);
+
+    if (built) {
+      level.entries = book + total;
+      total += expand_book_level(&level, threads);
+      count = unique_book_keys(level.children, states, sizeof(BookKey_t));
+    }
+
+    free(frontier);
+    frontier = level.children;
+  }
+
+  free(frontier);
+
+  if (built) {
+    total = unique_book_keys(book, total, sizeof(BookEntry_t));
+    built = write_book(path, book, total);
+  }
+
+  if (built) {
+    printf("book: %u states for the first %d pieces written to %s\n", total,
+           depth, path);
+  } else {
+    printf("book: cannot build %s\n", path);
+  }
+  free(book);
+
+  return built ? 0 : 1;
+}
+
+uint32_t expand_book_level(BookLevel_t *level, int threads) {
+  run_workers(expand_book_nodes, level, threads);
+
+  return unique_book_keys(level->entries, level->count * LEN(figures),
+                          sizeof(BookEntry_t));
+}
+
+void *expand_book_nodes(void *arg) {
+  BookLevel_t *level = (BookLevel_t *)arg;
+
+  for (;;) {
+    uint32_t first = atomic_fetch_add(&level->next, BOOK_CHUNK);
+    if (first >= level->count) break;
+
+    uint32_t last =
+        first + BOOK_CHUNK < level->count ? first + BOOK_CHUNK : level->count;
+    for (uint32_t index = first; index < last; index++) {
+      expand_book_node(&level->frontier[index],
+                       &level->entries[index * LEN(figures)],
+                       &level->children[index * LEN(figures)]);
+    }
+  }
+
+  return NULL;
+}
+
+void expand_book_node(const BookKey_t *node, BookEntry_t entries[],
+                      BookKey_t children[]) {
+  uint8_t current[SHAPE_SIZE];
+  figure_to_mask(node->current - 1, current);
+
+  for (int next = 0; next < (int)LEN(figures); next++) {
+    uint8_t shape[SHAPE_SIZE];
+    Placement_t best;
+
+    figure_to_mask(next, shape);
+    memset(&entries[next], 0, sizeof(entries[next]));
+    memset(&children[next], 0, sizeof(children[next]));
+
+    if (best_board_placement(&node->board, current, shape, &best)) {
+      entries[next].key = *node;
+      entries[next].key.next = (uint8_t)(next + 1);
+      entries[next].rotation = (uint8_t)best.rotation;
+      entries[next].x = (int8_t)best.x;
+
+      children[next].board = node->board;
+      children[next].current = (uint8_t)(next + 1);
+      board_place(&children[next].board, best.mask, best.x, best.y);
+      board_clear_lines(&children[next].board);
+    }
+  }
+}
+
+uint32_t unique_book_keys(void *keys, uint32_t count, size_t size) {
+  uint8_t *items = (uint8_t *)keys;
+  uint32_t unique = 0;
+
+  qsort(items, count, size, compare_book_keys);
+
+  for (uint32_t i = 0; i < count; i++) {
+    const BookKey_t *key = (const BookKey_t *)(items + i * size);
+
+    if (key->current != 0 &&
+        (unique == 0 ||
+         compare_book_keys(items + (unique - 1) * size, key) != 0)) {
+      memmove(items + unique++ * size, key, size);
+    }
+  }
+
+  return unique;
+}
+
+int compare_book_keys(const void *first, const void *second) {
+  return memcmp(first, second, sizeof(BookKey_t));
+}
+
+bool write_book(const char *path, BookEntry_t *entries, uint32_t count) {
+  uint32_t buckets = count / BOOK_BUCKET_SIZE + 1;
+  uint32_t slots = count + count / 4 + 1;
+  uint32_t *displacements = (uint32_t *)calloc(buckets, sizeof(uint32_t));
+  BookEntry_t *table = (BookEntry_t *)calloc(slots, sizeof(BookEntry_t));
+  bool written = (displacements != NULL && table != NULL) &&
+                 build_book_table(entries, count, buckets, slots,
+                                  displacements, table);
+
+  uint8_t header[BOOK_HEADER_SIZE];
+  uint8_t *cursor = header;
+  uint16_t version = BOOK_VERSION;
+  uint16_t entry_size = sizeof(BookEntry_t);
+
+  put_bytes(&cursor, BOOK_MAGIC, 4);
+  put_bytes(&cursor, &version, sizeof(version));
+  put_bytes(&cursor, &entry_size, sizeof(entry_size));
+  put_bytes(&cursor, &count, sizeof(count));
+  put_bytes(&cursor, &buckets, sizeof(buckets));
+  put_bytes(&cursor, &slots, sizeof(slots));
+
+  char temporary[256];
+  snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+  FILE *book_file = written ? fopen(temporary, "wb") : NULL;
+  written = (book_file != NULL);
+
+  if (book_file != NULL) {
+    written = fwrite(header, sizeof(header), 1, book_file) == 1 &&
+              fwrite(displacements, sizeof(uint32_t), buckets, book_file) ==
+                  buckets &&
+              fwrite(table, sizeof(BookEntry_t), slots, book_file) == slots;
+    written = (fclose(book_file) == 0) && written;
+    written = written && rename(temporary, path) == 0;
+  }
+
+  free(displacements);
+  free(table);
+
+  return written;
+}
+
+bool build_book_table(const BookEntry_t *entries, uint32_t count,
+                      uint32_t buckets, uint32_t slots,
+                      uint32_t displacements[], BookEntry_t table[]) {
+  BookBucket_t *order = (BookBucket_t *)malloc(count * sizeof(BookBucket_t));
+  uint32_t *sizes = (uint32_t *)calloc(buckets, sizeof(uint32_t));
+  bool built = (order != NULL && sizes != NULL) || count == 0;
+
+  for (uint32_t i = 0; built && i < count; i++) {
+    order[i].bucket =
+        (uint32_t)(hash_bytes(&entries[i].key, sizeof(BookKey_t), 0) %
+                   buckets);
+    order[i].entry = i;
+    sizes[order[i].bucket]++;
+  }
+
+  for (uint32_t i = 0; built && i < count; i++) {
+    order[i].size = sizes[order[i].bucket];
+  }
+
+  if (built && count > 0) {
+    qsort(order, count, sizeof(BookBucket_t), compare_book_buckets);
+  }
+
+  for (uint32_t i = 0; built && i < count; i += order[i].size) {
+    uint32_t displacement = 1;
+
+    while (displacement < BOOK_MAX_DISPLACEMENT &&
+           !place_book_bucket(entries, &order[i], displacement, slots, table)) {
+      displacement++;
+    }
+
+    displacements[order[i].bucket] = displacement;
+    built = (displacement < BOOK_MAX_DISPLACEMENT);
+  }
+
+  free(order);
+  free(sizes);
+
+  return built;
+}
+
+int compare_book_buckets(const void *first, const void *second) {
+  const BookBucket_t *a = (const BookBucket_t *)first;
+  const BookBucket_t *b = (const BookBucket_t *)second;
+
+  if (a->size != b->size) return (a->size > b->size) ? -1 : 1;
+  if (a->bucket != b->bucket) return (a->bucket < b->bucket) ? -1 : 1;
+
+  return 0;
+}
+
+bool place_book_bucket(const BookEntry_t *entries, const BookBucket_t *bucket,
+                       uint32_t displacement, uint32_t slots,
+                       BookEntry_t table[]) {
+  uint32_t used[BOOK_MAX_BUCKET];
+  uint32_t placed = 0;
+
+  if (bucket->size > BOOK_MAX_BUCKET) return false;
+
+  while (placed < bucket->size) {
+    const BookEntry_t *entry = &entries[bucket[placed].entry];
+    uint32_t slot = (uint32_t)(hash_bytes(&entry->key, sizeof(BookKey_t),
+                                          displacement) %
+                               slots);
+
+    if (table[slot].key.current != 0) break;
+
+    table[slot] = *entry;
+    used[placed++] = slot;
+  }
+
+  bool fits = (placed == bucket->size);
+
+  for (uint32_t i = 0; !fits && i < placed; i++) {
+    memset(&table[used[i]], 0, sizeof(BookEntry_t));
+  }
+
+  return fits;
+}
+
+bool book_open(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) return false;
+
+  struct stat status;
+  void *data = MAP_FAILED;
+
+  if (fstat(fd, &status) == 0 && status.st_size >= BOOK_HEADER_SIZE) {
+    data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+
+  close(fd);
+  if (data == MAP_FAILED) return false;
+
+  const uint8_t *cursor = (const uint8_t *)data;
+  char magic[4];
+  uint16_t version;
+  uint16_t entry_size;
+  uint32_t count;
+  uint32_t buckets;
+  uint32_t slots;
+
+  get_bytes(&cursor, magic, sizeof(magic));
+  get_bytes(&cursor, &version, sizeof(version));
+  get_bytes(&cursor, &entry_size, sizeof(entry_size));
+  get_bytes(&cursor, &count, sizeof(count));
+  get_bytes(&cursor, &buckets, sizeof(buckets));
+  get_bytes(&cursor, &slots, sizeof(slots));
+
+  bool valid = memcmp(magic, BOOK_MAGIC, 4) == 0 && version == BOOK_VERSION &&
+               entry_size == sizeof(BookEntry_t) && buckets > 0 &&
+               slots > 0 &&
+               (uint64_t)status.st_size ==
+                   BOOK_HEADER_SIZE + (uint64_t)buckets * sizeof(uint32_t) +
+                       (uint64_t)slots * sizeof(BookEntry_t);
+
+  if (!valid) {
+    munmap(data, status.st_size);
+    return false;
+  }
+
+  opening_book.data = (const uint8_t *)data;
+  opening_book.size = (size_t)status.st_size;
+  opening_book.displacements = (const uint32_t *)cursor;
+  opening_book.entries =
+      (const BookEntry_t *)(cursor + (size_t)buckets * sizeof(uint32_t));
+  opening_book.buckets = buckets;
+  opening_book.slots = slots;
+
+  return true;
+}
+
+void book_close() {
+  if (opening_book.data != NULL) {
+    munmap((void *)opening_book.data, opening_book.size);
+  }
+
+  memset(&opening_book, 0, sizeof(opening_book));
+}
+
+bool book_lookup(const BookKey_t *key, Placement_t *placement) {
+  uint32_t bucket = (uint32_t)(hash_bytes(key, sizeof(BookKey_t), 0) %
+                               opening_book.buckets);
+  uint32_t slot =
+      (uint32_t)(hash_bytes(key, sizeof(BookKey_t),
+                            opening_book.displacements[bucket]) %
+                 opening_book.slots);
+  const BookEntry_t *entry = &opening_book.entries[slot];
+  bool found = memcmp(&entry->key, key, sizeof(BookKey_t)) == 0;
+
+  if (found) {
+    placement->rotation = entry->rotation;
+    placement->x = entry->x;
+
+    figure_to_mask(key->current - 1, placement->mask);
+    for (int i = 0; i < entry->rotation; i++) {
+      uint8_t rotated[SHAPE_SIZE];
+      rotate_mask(placement->mask, rotated);
+      memcpy(placement->mask, rotated, SHAPE_SIZE);
+    }
+
+    placement->y = board_drop(&key->board, placement->mask, entry->x, 0);
+  }
+
+  return found;
+}
+
+bool book_placement(GameInfo_t *game, Placement_t *placement) {
+  if (opening_book.data == NULL) return false;
+
+  BookKey_t key;
+  uint8_t shape[SHAPE_SIZE];
+  uint8_t spawned[SHAPE_SIZE];
+
+  memset(&key, 0, sizeof(key));
+  board_from_game(game, &key.board);
+  key.current = game->figure.type;
+  key.next = game->next_figure.type;
+
+  shape_to_mask(game->figure.shape, shape);
+  figure_to_mask(key.current - 1, spawned);
+
+  bool found = memcmp(shape, spawned, SHAPE_SIZE) == 0 &&
+               book_lookup(&key, placement);
+
+  opening_book.lookups++;
+  opening_book.hits += found ? 1 : 0;
+
+  return found;
+}
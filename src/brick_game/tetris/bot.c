@@ -0,0 +1,231 @@
+#include "tetris.h"
+
+void start_bot(Bot_t *bot) {
+  bot->count = 0;
+  bot->next = 0;
+  bot->piece = -1;
+  bot->wait = 0;
+}
+
+UserAction_t bot_action(Bot_t *bot, GameInfo_t *game) {
+  UserAction_t action = (UserAction_t)-1;
+
+  if (game->state != MovingState) return action;
+
+  if (bot->piece != game->stats.pieces) {
+    bot->piece = game->stats.pieces;
+    plan_bot_actions(bot, game);
+  }
+
+  if (bot->wait > 0) {
+    bot->wait--;
+  } else if (bot->next < bot->count) {
+    action = bot->actions[bot->next++];
+    bot->wait = bot_input_frames(game) - 1;
+  }
+
+  return action;
+}
+
+void plan_bot_actions(Bot_t *bot, GameInfo_t *game) {
+  Placement_t best;
+
+  bot->count = 0;
+  bot->next = 0;
+  bot->wait = bot_input_frames(game) - 1;
+
+  if (find_best_placement(game, &best)) {
+    queue_placement(bot, game->figure.x, &best);
+  }
+}
+
+int bot_input_frames(const GameInfo_t *game) {
+  uint32_t frames = GRAVITY_ONE / game->gravity;
+
+  if (frames < 1) frames = 1;
+
+  return frames < BOT_INPUT_FRAMES ? (int)frames : BOT_INPUT_FRAMES;
+}
+
+bool find_best_placement(GameInfo_t *game, Placement_t *best) {
+  Board_t board;
+  uint8_t current[SHAPE_SIZE];
+  uint8_t next[SHAPE_SIZE];
+  Placement_t placements[MAX_PLACEMENTS];
+  Placement_t landed[MAX_PLACEMENTS];
+
+  board_from_game(game, &board);
+  shape_to_mask(game->figure.shape, current);
+  shape_to_mask(game->next_figure.shape, next);
+
+  int count = find_placements(&board, current, placements);
+  bool reachable = true;
+
+  for (int i = 0; i < count; i++) {
+    land_placement(&board, current, &placements[i], game->gravity,
+                   bot_input_frames(game), &landed[i]);
+    reachable = reachable && landed[i].x == placements[i].x &&
+                landed[i].y == placements[i].y &&
+                memcmp(landed[i].mask, placements[i].mask, SHAPE_SIZE) == 0;
+  }
+
+  if (reachable && book_placement(game, best)) return true;
+
+  int index = pick_best_placement(&board, landed, count, next);
+  if (index >= 0) *best = placements[index];
+
+  return (index >= 0);
+}
+
+bool best_board_placement(const Board_t *board, const uint8_t current[],
+                          const uint8_t next[], Placement_t *best) {
+  Placement_t placements[MAX_PLACEMENTS];
+  int count = find_placements(board, current, placements);
+
+  int index = pick_best_placement(board, placements, count, next);
+  if (index >= 0) *best = placements[index];
+
+  return (index >= 0);
+}
+
+int pick_best_placement(const Board_t *board, const Placement_t placements[],
+                        int count, const uint8_t next[]) {
+  double best_score = -1e9;
+  int best = -1;
+
+  for (int i = 0; i < count; i++) {
+    Board_t after = *board;
+    board_place(&after, placements[i].mask, placements[i].x, placements[i].y);
+    int lines = board_clear_lines(&after);
+
+    double score = best_followup_score(&after, next, lines);
+    if (score > best_score) {
+      best_score = score;
+      best = i;
+    }
+  }
+
+  return best;
+}
+
+void land_placement(const Board_t *board, const uint8_t shape[],
+                    const Placement_t *target, uint32_t gravity,
+                    int input_frames, Placement_t *landed) {
+  Bot_t route;
+  queue_placement(&route, HORISONTAL_FIELD_MIDDLE, target);
+
+  Placement_t piece = {0, HORISONTAL_FIELD_MIDDLE, 0, {0}};
+  memcpy(piece.mask, shape, SHAPE_SIZE);
+
+  uint32_t progress = 0;
+  int wait = input_frames - 1;
+  bool locked = false;
+
+  while (!locked) {
+    if (wait > 0) {
+      wait--;
+    } else if (route.next < route.count) {
+      locked = route_step(board, &piece, route.actions[route.next++]);
+      wait = input_frames - 1;
+    }
+
+    progress += gravity;
+    int rows = (int)(progress / GRAVITY_ONE);
+    progress %= GRAVITY_ONE;
+
+    if (!locked && rows > 0) {
+      int distance = board_drop(board, piece.mask, piece.x, piece.y) - piece.y;
+      locked = (distance == 0);
+      piece.y += (rows < distance) ? rows : distance;
+    }
+  }
+
+  *landed = piece;
+}
+
+bool route_step(const Board_t *board, Placement_t *piece,
+                UserAction_t action) {
+  bool locked = false;
+
+  if (action == Action) {
+    uint8_t rotated[SHAPE_SIZE];
+    rotate_mask(piece->mask, rotated);
+
+    if (board_fits(board, rotated, piece->x, piece->y)) {
+      memcpy(piece->mask, rotated, SHAPE_SIZE);
+      piece->rotation++;
+    }
+  } else if (action == Left || action == Right) {
+    int x = piece->x + (action == Left ? -1 : 1);
+    if (board_fits(board, piece->mask, x, piece->y)) piece->x = x;
+  } else if (action == Down) {
+    piece->y = board_drop(board, piece->mask, piece->x, piece->y);
+    locked = true;
+  }
+
+  return locked;
+}
+
+double best_followup_score(const Board_t *board, const uint8_t shape[],
+                           int lines) {
+  Placement_t placements[MAX_PLACEMENTS];
+  int count = find_placements(board, shape, placements);
+  double best_score = (count > 0) ? -1e9 : evaluate_board(board, lines) - 1e3;
+
+  for (int i = 0; i < count; i++) {
+    Board_t after = *board;
+    board_place(&after, placements[i].mask, placements[i].x, placements[i].y);
+    int total_lines = lines + board_clear_lines(&after);
+
+    double score = evaluate_board(&after, total_lines);
+    if (score > best_score) {
+      best_score = score;
+    }
+  }
+
+  return best_score;
+}
+
+double evaluate_board(const Board_t *board, int lines) {
+  int heights[BOARD_WIDTH] = {0};
+  int holes = 0;
+
+  for (int column = 0; column < BOARD_WIDTH; column++) {
+    uint8_t bit = (uint8_t)(1u << column);
+
+    for (int row = 0; row < LINES_NUMBER; row++) {
+      if (board->rows[row] & bit) {
+        if (heights[column] == 0) heights[column] = LINES_NUMBER - row;
+      } else if (heights[column] != 0) {
+        holes++;
+      }
+    }
+  }
+
+  int aggregate_height = 0;
+  int bumpiness = 0;
+
+  for (int column = 0; column < BOARD_WIDTH; column++) {
+    aggregate_height += heights[column];
+    if (column > 0) bumpiness += abs(heights[column] - heights[column - 1]);
+  }
+
+  return -0.51 * aggregate_height + 0.76 * lines - 0.36 * holes -
+         0.18 * bumpiness;
+}
+
+void queue_placement(Bot_t *bot, int x, const Placement_t *placement) {
+  bot->count = 0;
+  bot->next = 0;
+
+  for (int i = 0; i < placement->rotation; i++) {
+    bot->actions[bot->count++] = Action;
+  }
+
+  int shift = placement->x - x;
+  for (int i = 0; i < abs(shift); i++) {
+    bot->actions[bot->count++] = shift < 0 ? Left : Right;
+  }
+
+  bot->actions[bot->count++] = Down;
+}
@@ -0,0 +1,75 @@
+#include "tetris.h"
+
+const char *event_names[] = {[EventSpawned] = "spawned",
+                             [EventMoved] = "moved",
+                             [EventRotated] = "rotated",
+                             [EventLocked] = "locked",
+                             [EventLinesCleared] = "lines_cleared",
+                             [EventLevelUp] = "level_up",
+                             [EventGameOver] = "game_over"};
+
+static EventSubscriber_t event_subscribers[EVENT_MAX_HANDLERS] = {
+    {telemetry_event, NULL}};
+static int event_subscriber_count = 1;
+
+void emit_event(GameInfo_t *game, EventKind_t kind, int lines, uint32_t rows) {
+  if (game->event_count == EVENT_CAPACITY) {
+    game->dropped_events++;
+    return;
+  }
+
+  GameEvent_t *event = &game->events[game->event_count++];
+  event->kind = kind;
+  event->piece = game->figure.type;
+  event->x = game->figure.x;
+  event->y = game->figure.y;
+  event->lines = lines;
+  event->rows = rows;
+  event->stack_height = (kind == EventLocked) ? stack_height(game) : 0;
+  event->score = game->score;
+  event->level = game->level;
+}
+
+int drain_events(GameInfo_t *game) {
+  int count = game->event_count;
+
+  for (int i = 0; i < count; i++) {
+    for (int j = 0; j < event_subscriber_count; j++) {
+      event_subscribers[j].handler(game, &game->events[i],
+                                   event_subscribers[j].context);
+    }
+  }
+
+  game->event_count = 0;
+
+  return count;
+}
+
+bool add_event_handler(EventHandler_t handler, void *context) {
+  if (event_subscriber_count == EVENT_MAX_HANDLERS) return false;
+
+  event_subscribers[event_subscriber_count].handler = handler;
+  event_subscribers[event_subscriber_count].context = context;
+  event_subscriber_count++;
+
+  return true;
+}
+
+void telemetry_event(GameInfo_t *game, const GameEvent_t *event,
+                     void *context) {
+  (void)context;
+
+  if (event->kind == EventLocked) {
+    count_locked_piece(game, event);
+  }
+}
+
+void trace_game_event(GameInfo_t *game, const GameEvent_t *event,
+                      void *context) {
+  (void)game;
+  (void)context;
+
+  if (trace_enabled) {
+    trace_event(event_names[event->kind], 'i');
+  }
+}
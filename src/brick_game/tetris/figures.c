@@ -1,5 +1,16 @@
 #include "tetris.h"
 
+const char figure_names[] = "OITLJZS";
+
+const uint32_t level_gravity[LEVEL_MAX] = {
+    GRAVITY_MS(275),     GRAVITY_MS(250),     GRAVITY_MS(225),
+    GRAVITY_MS(200),     GRAVITY_MS(175),     GRAVITY_MS(150),
+    GRAVITY_MS(125),     GRAVITY_MS(100),     GRAVITY_MS(75),
+    GRAVITY_MS(50),      GRAVITY_ONE / 2,     GRAVITY_ONE * 3 / 4,
+    GRAVITY_ONE,         GRAVITY_ONE * 3 / 2, GRAVITY_ONE * 2,
+    GRAVITY_ONE * 3,     GRAVITY_ONE * 5,     GRAVITY_ONE * 8,
+    GRAVITY_ONE * 12,    GRAVITY_ONE * 20};
+
 const int figures[7][4][4] = {
     // Квадрат
     {{32, 32, 32, 32}, {32, 42, 42, 32}, {32, 42, 42, 32}, {32, 32, 32, 32}},
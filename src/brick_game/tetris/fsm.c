@@ -0,0 +1,93 @@
+#include "tetris.h"
+
+const State_t game_states[] = {
+    [StartState] = {"start", start_state, true},
+    [SpawnState] = {"spawn", spawn_state, true},
+    [MovingState] = {"moving", moving_state, false},
+    [ShiftingState] = {"shifting", shifting_state, true},
+    [AttachingState] = {"attaching", attaching_state, true},
+    [PauseState] = {"pause", pause_state, false},
+    [GameOverState] = {"game_over", game_over_state, false}};
+
+void update_state(GameInfo_t *game, UserAction_t action) {
+  bool transient = true;
+
+  while (transient && !game->exit) {
+    const State_t *state = &game_states[game->state];
+
+    TRACE_BEGIN(state->name);
+    state->handler(game, action);
+    TRACE_END(state->name);
+
+    action = (UserAction_t)-1;
+    transient = game_states[game->state].transient;
+  }
+}
+
+void start_state(GameInfo_t *game, UserAction_t action) {
+  if (action == Terminate) {
+    game->exit = 1;
+  } else {
+    game->state = SpawnState;
+  }
+}
+
+void spawn_state(GameInfo_t *game, UserAction_t action) {
+  (void)action;
+
+  TRACE_BEGIN("check_game_over");
+  check_game_over(game);
+  TRACE_END("check_game_over");
+
+  if (game->state != GameOverState) {
+    place_figure(game);
+    emit_event(game, EventSpawned, 0, 0);
+    game->state = MovingState;
+  }
+}
+
+void moving_state(GameInfo_t *game, UserAction_t action) {
+  game->state = ShiftingState;
+
+  TRACE_BEGIN("handle_user_input");
+  handle_user_input(game, action);
+  TRACE_END("handle_user_input");
+}
+
+void shifting_state(GameInfo_t *game, UserAction_t action) {
+  (void)action;
+
+  TRACE_BEGIN("gravity");
+  gravity(game);
+  TRACE_END("gravity");
+}
+
+void attaching_state(GameInfo_t *game, UserAction_t action) {
+  (void)action;
+
+  place_figure(game);
+
+  TRACE_BEGIN("remove_completed_lines");
+  int lines = remove_completed_lines(game);
+  TRACE_END("remove_completed_lines");
+
+  emit_event(game, EventLocked, lines, 0);
+  drop_next_figure(game);
+
+  game->state = SpawnState;
+}
+
+void pause_state(GameInfo_t *game, UserAction_t action) {
+  if (action == Start) {
+    count_action(game, action);
+    game->state = MovingState;
+  } else if (action == Terminate) {
+    game->exit = 1;
+  }
+}
+
+void game_over_state(GameInfo_t *game, UserAction_t action) {
+  (void)action;
+
+  game->exit = 1;
+}
@@ -0,0 +1,294 @@
+#include "tetris.h"
+
+int run_puzzle(const char *path, int threads) {
+  Puzzle_t puzzle;
+
+  if (!load_puzzle(path, &puzzle)) {
+    fprintf(stderr, "puzzle: cannot read %s\n", path);
+    return 1;
+  }
+
+  if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads <= 0) threads = 1;
+
+  uint64_t started = monotonic_time();
+  int status = solve_puzzle(&puzzle, threads);
+  double elapsed = (monotonic_time() - started) / 1e9;
+
+  long states = atomic_load(&puzzle.states);
+  printf("puzzle: %ld states in %.3fs (%.0f states/s) on %d threads\n",
+         states, elapsed, elapsed > 0 ? states / elapsed : 0.0, threads);
+
+  free_puzzle(&puzzle);
+
+  return status;
+}
+
+bool load_puzzle(const char *path, Puzzle_t *puzzle) {
+  FILE *puzzle_file = fopen(path, "r");
+  char line[256];
+  int rows = 0;
+  uint8_t board[LINES_NUMBER] = {0};
+
+  memset(puzzle, 0, sizeof(*puzzle));
+  if (puzzle_file == NULL) return false;
+
+  while (fgets(line, sizeof(line), puzzle_file) != NULL) {
+    line[strcspn(line, "\r\n")] = '\0';
+
+    if (strncmp(line, "pieces", 6) == 0) {
+      read_puzzle_pieces(puzzle, line + 6);
+    } else if (strlen(line) == BOARD_WIDTH &&
+               strspn(line, ".#") == BOARD_WIDTH && rows < LINES_NUMBER) {
+      board[rows++] = read_puzzle_row(line);
+    }
+  }
+
+  fclose(puzzle_file);
+
+  memcpy(&puzzle->board.rows[LINES_NUMBER - rows], board, rows);
+
+  return (puzzle->count > 0);
+}
+
+uint8_t read_puzzle_row(const char *line) {
+  uint8_t row = 0;
+
+  for (int column = 0; column < BOARD_WIDTH; column++) {
+    if (line[column] == '#') {
+      row |= (uint8_t)(1u << column);
+    }
+  }
+
+  return row;
+}
+
+void read_puzzle_pieces(Puzzle_t *puzzle, const char *line) {
+  for (; *line != '\0' && puzzle->count < PUZZLE_MAX_PIECES; line++) {
+    const char *name = strchr(figure_names, *line);
+
+    if (name != NULL) {
+      puzzle->pieces[puzzle->count++] = (int)(name - figure_names);
+    }
+  }
+}
+
+int solve_puzzle(Puzzle_t *puzzle, int threads) {
+  PuzzleNode_t root = {puzzle->board, 0, 0, 0};
+
+  puzzle->depth = 1;
+  if (!allocate_puzzle_level(&puzzle->levels[0], 1)) return 1;
+  insert_puzzle_node(&puzzle->levels[0], &root);
+
+  for (int depth = 0; depth < puzzle->count; depth++) {
+    PuzzleLevel_t *current = &puzzle->levels[depth];
+    uint32_t frontier = atomic_load(&current->count);
+    uint64_t bound = (uint64_t)frontier * MAX_PLACEMENTS;
+
+    if (frontier == 0) break;
+
+    puzzle->depth = depth + 2;
+    if (!allocate_puzzle_level(&puzzle->levels[depth + 1],
+                               bound < PUZZLE_MAX_NODES ? (uint32_t)bound
+                                                        : PUZZLE_MAX_NODES)) {
+      printf("puzzle: out of memory at depth %d\n", depth + 1);
+      return 1;
+    }
+
+    expand_puzzle_level(puzzle, depth, threads);
+    free(current->table);
+    current->table = NULL;
+
+    if (atomic_load(&puzzle->overflow)) {
+      printf("puzzle: more than %d states at depth %d\n", PUZZLE_MAX_NODES,
+             depth + 1);
+      return 1;
+    }
+
+    if (atomic_load(&puzzle->solution) != 0) {
+      print_puzzle_solution(puzzle, depth + 1);
+      return 0;
+    }
+  }
+
+  printf("puzzle: no sequence of %d pieces clears the board\n",
+         puzzle->count);
+
+  return 1;
+}
+
+bool allocate_puzzle_level(PuzzleLevel_t *level, uint32_t capacity) {
+  uint32_t table_size = 1;
+  while (table_size < capacity * 2) table_size <<= 1;
+
+  level->nodes = (PuzzleNode_t *)malloc(capacity * sizeof(PuzzleNode_t));
+  level->table = (atomic_uint *)calloc(table_size, sizeof(atomic_uint));
+  level->capacity = capacity;
+  level->table_mask = table_size - 1;
+  atomic_store(&level->count, 0);
+  atomic_store(&level->next, 0);
+
+  return (level->nodes != NULL && level->table != NULL);
+}
+
+void expand_puzzle_level(Puzzle_t *puzzle, int depth, int threads) {
+  PuzzleWorker_t worker = {puzzle, depth};
+
+  run_workers(expand_puzzle_nodes, &worker, threads);
+}
+
+void *expand_puzzle_nodes(void *arg) {
+  PuzzleWorker_t *worker = (PuzzleWorker_t *)arg;
+  Puzzle_t *puzzle = worker->puzzle;
+  PuzzleLevel_t *current = &puzzle->levels[worker->depth];
+  PuzzleLevel_t *next = &puzzle->levels[worker->depth + 1];
+  uint32_t frontier = atomic_load(&current->count);
+  uint8_t shape[SHAPE_SIZE];
+  long states = 0;
+
+  figure_to_mask(puzzle->pieces[worker->depth], shape);
+
+  for (;;) {
+    uint32_t first = atomic_fetch_add(&current->next, PUZZLE_CHUNK);
+    if (first >= frontier || atomic_load(&puzzle->overflow)) break;
+
+    uint32_t last = first + PUZZLE_CHUNK < frontier ? first + PUZZLE_CHUNK
+                                                    : frontier;
+    for (uint32_t index = first; index < last; index++) {
+      states += expand_puzzle_node(puzzle, next, index,
+                                   &current->nodes[index].board, shape);
+    }
+  }
+
+  atomic_fetch_add(&puzzle->states, states);
+
+  return NULL;
+}
+
+int expand_puzzle_node(Puzzle_t *puzzle, PuzzleLevel_t *next, uint32_t parent,
+                       const Board_t *board, const uint8_t shape[]) {
+  Placement_t placements[MAX_PLACEMENTS];
+  int count = find_placements(board, shape, placements);
+  int states = 0;
+
+  for (int i = 0; i < count; i++) {
+    PuzzleNode_t child = {*board, parent, (uint8_t)placements[i].rotation,
+                          (int8_t)placements[i].x};
+    board_place(&child.board, placements[i].mask, placements[i].x,
+                placements[i].y);
+    board_clear_lines(&child.board);
+
+    uint32_t index = insert_puzzle_node(next, &child);
+
+    if (index == PUZZLE_FULL) {
+      atomic_store(&puzzle->overflow, true);
+    } else if (index != PUZZLE_DUPLICATE) {
+      states++;
+
+      if (board_is_empty(&child.board)) {
+        unsigned int expected = 0;
+        atomic_compare_exchange_strong(&puzzle->solution, &expected,
+                                       index + 1);
+      }
+    }
+  }
+
+  return states;
+}
+
+uint32_t insert_puzzle_node(PuzzleLevel_t *level, const PuzzleNode_t *node) {
+  uint32_t slot = (uint32_t)hash_bytes(&node->board, sizeof(Board_t), 0) &
+                  level->table_mask;
+
+  for (;;) {
+    unsigned int expected = 0;
+
+    if (atomic_compare_exchange_strong(&level->table[slot], &expected,
+                                       PUZZLE_WRITING)) {
+      return append_puzzle_node(level, slot, node);
+    }
+
+    while (expected == PUZZLE_WRITING) {
+      expected = atomic_load(&level->table[slot]);
+    }
+
+    if (expected != PUZZLE_FULL &&
+        memcmp(&level->nodes[expected - 1].board, &node->board,
+               sizeof(Board_t)) == 0) {
+      return PUZZLE_DUPLICATE;
+    }
+
+    slot = (slot + 1) & level->table_mask;
+  }
+}
+
+uint32_t append_puzzle_node(PuzzleLevel_t *level, uint32_t slot,
+                            const PuzzleNode_t *node) {
+  uint32_t index = atomic_fetch_add(&level->count, 1);
+
+  if (index >= level->capacity) {
+    atomic_store(&level->count, level->capacity);
+    atomic_store(&level->table[slot], PUZZLE_FULL);
+    return PUZZLE_FULL;
+  }
+
+  level->nodes[index] = *node;
+  atomic_store(&level->table[slot], index + 1);
+
+  return index;
+}
+
+void figure_to_mask(int type, uint8_t mask[]) {
+  int shape[SHAPE_SIZE][SHAPE_SIZE];
+
+  memcpy(shape, figures[type], sizeof(shape));
+  shape_to_mask(shape, mask);
+}
+
+void print_puzzle_solution(Puzzle_t *puzzle, int depth) {
+  uint32_t moves[PUZZLE_MAX_PIECES];
+  uint32_t index = atomic_load(&puzzle->solution) - 1;
+
+  for (int level = depth; level > 0; level--) {
+    moves[level - 1] = index;
+    index = puzzle->levels[level].nodes[index].parent;
+  }
+
+  printf("puzzle: cleared with %d placements\n", depth);
+
+  for (int level = 1; level <= depth; level++) {
+    PuzzleNode_t *node = &puzzle->levels[level].nodes[moves[level - 1]];
+    int type = puzzle->pieces[level - 1];
+    uint8_t mask[SHAPE_SIZE];
+
+    figure_to_mask(type, mask);
+    for (int i = 0; i < node->rotation; i++) {
+      uint8_t rotated[SHAPE_SIZE];
+      rotate_mask(mask, rotated);
+      memcpy(mask, rotated, SHAPE_SIZE);
+    }
+
+    printf("%d. %c rotation %d column %d\n", level, figure_names[type],
+           node->rotation, leftmost_column(mask, node->x));
+  }
+}
+
+int leftmost_column(const uint8_t mask[], int x) {
+  uint8_t columns = 0;
+
+  for (int i = 0; i < SHAPE_SIZE; i++) {
+    columns |= mask[i];
+  }
+
+  int column = 0;
+  while (columns != 0 && !(columns & (1u << column))) column++;
+
+  return x + column;
+}
+
+void free_puzzle(Puzzle_t *puzzle) {
+  for (int level = 0; level < puzzle->depth; level++) {
+    free(puzzle->levels[level].nodes);
+    free(puzzle->levels[level].table);
+  }
+}
@@ -0,0 +1,249 @@
+#include "tetris.h"
+
+_Static_assert(SAVE_PAYLOAD_SIZE == 149,
+               "the save layout changed, bump SAVE_VERSION and this size");
+
+bool save_enabled = true;
+
+bool save_game(GameInfo_t *game, const char *path) {
+  uint8_t buffer[SAVE_HEADER_SIZE + SAVE_PAYLOAD_SIZE];
+  uint8_t *payload = buffer + SAVE_HEADER_SIZE;
+  uint8_t *cursor = buffer;
+
+  uint16_t version = SAVE_VERSION;
+  uint16_t size = SAVE_PAYLOAD_SIZE;
+  serialize_game(game, payload);
+  uint32_t checksum = crc32(payload, SAVE_PAYLOAD_SIZE);
+
+  put_bytes(&cursor, SAVE_MAGIC, 4);
+  put_bytes(&cursor, &version, sizeof(version));
+  put_bytes(&cursor, &size, sizeof(size));
+  put_bytes(&cursor, &checksum, sizeof(checksum));
+
+  char temporary[256];
+  snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+
+  FILE *save_file = fopen(temporary, "wb");
+  bool saved = false;
+
+  if (save_file != NULL) {
+    saved = fwrite(buffer, sizeof(buffer), 1, save_file) == 1;
+    saved = (fclose(save_file) == 0) && saved;
+    saved = saved && rename(temporary, path) == 0;
+  }
+
+  return saved;
+}
+
+bool load_game(GameInfo_t *game, const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) return false;
+
+  struct stat status;
+  bool loaded = false;
+
+  if (fstat(fd, &status) == 0 &&
+      status.st_size == SAVE_HEADER_SIZE + SAVE_PAYLOAD_SIZE) {
+    void *data = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data != MAP_FAILED) {
+      loaded = restore_game(game, (const uint8_t *)data);
+      munmap(data, status.st_size);
+    }
+  }
+
+  close(fd);
+
+  return loaded;
+}
+
+bool restore_game(GameInfo_t *game, const uint8_t *data) {
+  const uint8_t *cursor = data;
+  char magic[4];
+  uint16_t version;
+  uint16_t size;
+  uint32_t checksum;
+
+  get_bytes(&cursor, magic, sizeof(magic));
+  get_bytes(&cursor, &version, sizeof(version));
+  get_bytes(&cursor, &size, sizeof(size));
+  get_bytes(&cursor, &checksum, sizeof(checksum));
+
+  bool valid = memcmp(magic, SAVE_MAGIC, 4) == 0 && version == SAVE_VERSION &&
+               size == SAVE_PAYLOAD_SIZE &&
+               checksum == crc32(cursor, SAVE_PAYLOAD_SIZE);
+
+  if (valid) {
+    GameInfo_t saved = *game;
+    valid = deserialize_game(&saved, cursor);
+
+    if (valid) {
+      *game = saved;
+      place_figure(game);
+      display_next_figure(game);
+    }
+  }
+
+  return valid;
+}
+
+void serialize_game(GameInfo_t *game, uint8_t *payload) {
+  uint8_t packed[SAVE_FIELD_SIZE];
+  uint8_t *cursor = payload;
+  Telemetry_t *stats = &game->stats;
+
+  remove_figure(game);
+  pack_field(game, packed);
+  place_figure(game);
+
+  uint16_t figure = shape_to_bits(game->figure.shape);
+  uint16_t next = shape_to_bits(game->next_figure.shape);
+  int8_t x = (int8_t)game->figure.x;
+  int8_t y = (int8_t)game->figure.y;
+  uint8_t pause = (game->state == PauseState);
+  uint64_t played = monotonic_time() - stats->started;
+
+  put_bytes(&cursor, packed, sizeof(packed));
+  put_bytes(&cursor, &figure, sizeof(figure));
+  put_bytes(&cursor, &x, sizeof(x));
+  put_bytes(&cursor, &y, sizeof(y));
+  put_bytes(&cursor, &game->figure.type, sizeof(game->figure.type));
+  put_bytes(&cursor, &next, sizeof(next));
+  put_bytes(&cursor, &game->next_figure.type, sizeof(game->next_figure.type));
+  put_bytes(&cursor, &game->seed, sizeof(game->seed));
+  put_bytes(&cursor, &game->score, sizeof(game->score));
+  put_bytes(&cursor, &game->level, sizeof(game->level));
+  put_bytes(&cursor, &pause, sizeof(pause));
+  put_bytes(&cursor, &played, sizeof(played));
+  put_bytes(&cursor, &stats->paused_time, sizeof(stats->paused_time));
+  put_bytes(&cursor, &stats->pieces, sizeof(stats->pieces));
+  put_bytes(&cursor, &stats->actions, sizeof(stats->actions));
+  put_bytes(&cursor, &stats->hard_drops, sizeof(stats->hard_drops));
+  put_bytes(&cursor, stats->cleared, sizeof(stats->cleared));
+  put_bytes(&cursor, &stats->stack_height_sum,
+            sizeof(stats->stack_height_sum));
+
+  assert((size_t)(cursor - payload) == SAVE_PAYLOAD_SIZE);
+}
+
+bool deserialize_game(GameInfo_t *game, const uint8_t *payload) {
+  uint8_t packed[SAVE_FIELD_SIZE];
+  const uint8_t *cursor = payload;
+  Telemetry_t *stats = &game->stats;
+  uint16_t figure;
+  uint16_t next;
+  int8_t x;
+  int8_t y;
+  uint8_t pause;
+
+  get_bytes(&cursor, packed, sizeof(packed));
+  get_bytes(&cursor, &figure, sizeof(figure));
+  get_bytes(&cursor, &x, sizeof(x));
+  get_bytes(&cursor, &y, sizeof(y));
+  get_bytes(&cursor, &game->figure.type, sizeof(game->figure.type));
+  get_bytes(&cursor, &next, sizeof(next));
+  get_bytes(&cursor, &game->next_figure.type, sizeof(game->next_figure.type));
+  get_bytes(&cursor, &game->seed, sizeof(game->seed));
+  get_bytes(&cursor, &game->score, sizeof(game->score));
+  get_bytes(&cursor, &game->level, sizeof(game->level));
+  get_bytes(&cursor, &pause, sizeof(pause));
+  get_bytes(&cursor, &stats->resumed, sizeof(stats->resumed));
+  get_bytes(&cursor, &stats->paused_time, sizeof(stats->paused_time));
+  get_bytes(&cursor, &stats->pieces, sizeof(stats->pieces));
+  get_bytes(&cursor, &stats->actions, sizeof(stats->actions));
+  get_bytes(&cursor, &stats->hard_drops, sizeof(stats->hard_drops));
+  get_bytes(&cursor, stats->cleared, sizeof(stats->cleared));
+  get_bytes(&cursor, &stats->stack_height_sum,
+            sizeof(stats->stack_height_sum));
+
+  assert((size_t)(cursor - payload) == SAVE_PAYLOAD_SIZE);
+
+  bits_to_shape(figure, game->figure.shape);
+  bits_to_shape(next, game->next_figure.shape);
+  game->figure.x = x;
+  game->figure.y = y;
+  game->state = pause ? PauseState : MovingState;
+  stats->paused_since = monotonic_time();
+
+  bool valid = unpack_field(packed, game) && figure != 0 && next != 0 &&
+               game->seed != 0 && game->figure.type >= 1 &&
+               game->figure.type <= LEN(figures) &&
+               game->next_figure.type >= 1 &&
+               game->next_figure.type <= LEN(figures) && game->score >= 0 &&
+               game->level >= 1 && game->level <= LEVEL_MAX &&
+               can_place(game, game->figure.shape);
+
+  if (valid) game->gravity = level_gravity[game->level - 1];
+
+  return valid;
+}
+
+void pack_field(GameInfo_t *game, uint8_t packed[]) {
+  Cell_t *cells = &game->field[0][0];
+
+  for (int i = 0; i < SAVE_FIELD_SIZE; i++) {
+    packed[i] = (uint8_t)(cells[2 * i] | (cells[2 * i + 1] << 4));
+  }
+}
+
+bool unpack_field(const uint8_t packed[], GameInfo_t *game) {
+  Cell_t *cells = &game->field[0][0];
+  bool valid = true;
+
+  for (int i = 0; i < SAVE_FIELD_SIZE; i++) {
+    cells[2 * i] = packed[i] & 0x0F;
+    cells[2 * i + 1] = packed[i] >> 4;
+
+    valid = valid && cells[2 * i] <= LEN(figures) &&
+            cells[2 * i + 1] <= LEN(figures);
+  }
+
+  return valid;
+}
+
+uint16_t shape_to_bits(int shape[SHAPE_SIZE][SHAPE_SIZE]) {
+  uint16_t bits = 0;
+
+  for (int i = 0; i < SHAPE_SIZE; i++) {
+    for (int j = 0; j < SHAPE_SIZE; j++) {
+      if (shape[i][j] != SPACE) {
+        bits |= (uint16_t)(1u << (i * SHAPE_SIZE + j));
+      }
+    }
+  }
+
+  return bits;
+}
+
+void bits_to_shape(uint16_t bits, int shape[SHAPE_SIZE][SHAPE_SIZE]) {
+  for (int i = 0; i < SHAPE_SIZE; i++) {
+    for (int j = 0; j < SHAPE_SIZE; j++) {
+      bool filled = bits & (1u << (i * SHAPE_SIZE + j));
+      shape[i][j] = filled ? BLOCK : SPACE;
+    }
+  }
+}
+
+void put_bytes(uint8_t **cursor, const void *value, size_t size) {
+  memcpy(*cursor, value, size);
+  *cursor += size;
+}
+
+void get_bytes(const uint8_t **cursor, void *value, size_t size) {
+  memcpy(value, *cursor, size);
+  *cursor += size;
+}
+
+uint32_t crc32(const uint8_t *data, size_t size) {
+  uint32_t crc = 0xFFFFFFFFu;
+
+  for (size_t i = 0; i < size; i++) {
+    crc ^= data[i];
+
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+
+  return ~crc;
+}
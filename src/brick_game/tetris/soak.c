@@ -0,0 +1,169 @@
+#include "tetris.h"
+
+int run_soak(double hours) {
+  SoakState_t soak;
+  memset(&soak, 0, sizeof(soak));
+
+  soak.duration = (uint64_t)(hours * 3600e9);
+  soak.interval = soak.duration / SOAK_SAMPLES;
+  soak.next_sample = soak.interval;
+  if (soak.interval == 0) soak.interval = soak.next_sample = soak.duration;
+
+  while (!soak.failed && soak.simulated < soak.duration) {
+    play_soak_game(&soak);
+  }
+
+  printf("soak: %s after %.2fh of simulated time, %ld games, %ld pieces\n",
+         soak.failed ? "FAILED" : "passed", soak.simulated / 3600e9,
+         soak.games, soak.pieces);
+
+  if (opening_book.data != NULL) {
+    printf("soak: opening book answered %ld of %ld bot moves\n",
+           opening_book.hits, opening_book.lookups);
+  }
+
+  return soak.failed ? 1 : 0;
+}
+
+void play_soak_game(SoakState_t *soak) {
+  GameInfo_t game;
+  Bot_t bot;
+
+  prepare_game(&game, (unsigned int)(soak->games + 1));
+  game.headless = 1;
+  begin_telemetry(&game);
+  start_bot(&bot);
+
+  while (!game.exit && !soak->failed && soak->simulated < soak->duration) {
+    uint64_t tick_start = monotonic_time();
+
+    update_state(&game, bot_action(&bot, &game));
+    drain_events(&game);
+
+    record_latency(&soak->latency, monotonic_time() - tick_start);
+    soak->simulated += FRAME_TIME;
+
+    if (soak->simulated >= soak->next_sample) {
+      take_soak_sample(soak);
+      soak->next_sample += soak->interval;
+    }
+  }
+
+  soak->pieces += game.stats.pieces;
+  soak->games++;
+
+  finish_telemetry(&game);
+}
+
+void record_latency(LatencyHistogram_t *histogram, uint64_t nanoseconds) {
+  histogram->buckets[latency_bucket(nanoseconds)]++;
+  histogram->count++;
+
+  if (nanoseconds > histogram->max) {
+    histogram->max = nanoseconds;
+  }
+}
+
+int latency_bucket(uint64_t nanoseconds) {
+  int exponent = 0;
+
+  while ((nanoseconds >> exponent) >= SOAK_SUB_BUCKETS &&
+         exponent < SOAK_EXPONENTS - 1) {
+    exponent++;
+  }
+
+  uint64_t mantissa = nanoseconds >> exponent;
+  if (mantissa >= SOAK_SUB_BUCKETS) mantissa = SOAK_SUB_BUCKETS - 1;
+
+  return exponent * SOAK_SUB_BUCKETS + (int)mantissa;
+}
+
+uint64_t latency_percentile(const LatencyHistogram_t *histogram,
+                            double percentile) {
+  long target = (long)(histogram->count * percentile);
+  long seen = 0;
+  int bucket = 0;
+
+  for (; bucket < SOAK_BUCKETS - 1; bucket++) {
+    seen += histogram->buckets[bucket];
+    if (seen > target) break;
+  }
+
+  uint64_t upper = (uint64_t)(bucket % SOAK_SUB_BUCKETS + 1)
+                   << (bucket / SOAK_SUB_BUCKETS);
+
+  return (upper < histogram->max) ? upper : histogram->max;
+}
+
+void take_soak_sample(SoakState_t *soak) {
+  if (soak->latency.count < SOAK_MIN_TICKS) return;
+
+  long rss = resident_memory();
+  long heap = heap_in_use();
+  uint64_t p50 = latency_percentile(&soak->latency, 0.50);
+  uint64_t p99 = latency_percentile(&soak->latency, 0.99);
+
+  printf(
+      "soak: %.2fh games=%ld rss=%ldKB heap=%ldKB p50=%.1fus p99=%.1fus "
+      "max=%.1fus\n",
+      soak->simulated / 3600e9, soak->games, rss, heap, p50 / 1000.0,
+      p99 / 1000.0, soak->latency.max / 1000.0);
+  fflush(stdout);
+
+  if (soak->samples == SOAK_WARMUP_SAMPLES) {
+    soak->baseline_rss = rss;
+    soak->baseline_heap = heap;
+    soak->baseline_p99 = p99;
+  } else if (soak->samples > SOAK_WARMUP_SAMPLES) {
+    check_soak_drift(soak, rss, heap, p99);
+  }
+
+  soak->samples++;
+  memset(&soak->latency, 0, sizeof(soak->latency));
+}
+
+void check_soak_drift(SoakState_t *soak, long rss, long heap, uint64_t p99) {
+  long allowed_rss = soak->baseline_rss + soak->baseline_rss / 10 + 1024;
+  long allowed_heap = soak->baseline_heap + soak->baseline_heap / 10 + 64;
+  uint64_t allowed_p99 =
+      soak->baseline_p99 * SOAK_P99_DRIFT + SOAK_P99_TOLERANCE;
+
+  if (rss > allowed_rss) {
+    printf("soak: resident memory grew from %ldKB to %ldKB\n",
+           soak->baseline_rss, rss);
+    soak->failed = true;
+  }
+
+  if (heap > allowed_heap) {
+    printf("soak: heap in use grew from %ldKB to %ldKB\n", soak->baseline_heap,
+           heap);
+    soak->failed = true;
+  }
+
+  soak->drifting = (p99 > allowed_p99) ? soak->drifting + 1 : 0;
+
+  if (soak->drifting >= SOAK_DRIFT_SAMPLES) {
+    printf("soak: p99 tick time drifted from %.1fus to %.1fus\n",
+           soak->baseline_p99 / 1000.0, p99 / 1000.0);
+    soak->failed = true;
+  }
+}
+
+long resident_memory() {
+  long size = 0;
+  long resident = 0;
+  FILE *statm = fopen("/proc/self/statm", "r");
+
+  if (statm != NULL) {
+    if (fscanf(statm, "%ld %ld", &size, &resident) != 2) resident = 0;
+    fclose(statm);
+  }
+
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+long heap_in_use() {
+  struct mallinfo2 info = mallinfo2();
+
+  return (long)((info.uordblks + info.hblkhd) / 1024);
+}
@@ -0,0 +1,181 @@
+#include "tetris.h"
+
+bool telemetry_enabled = false;
+
+static TelemetryRecord_t telemetry_ring[TELEMETRY_RING_SIZE];
+static atomic_size_t telemetry_head = 0;
+static atomic_size_t telemetry_tail = 0;
+static atomic_size_t telemetry_dropped = 0;
+static atomic_bool telemetry_running = false;
+static pthread_t telemetry_writer;
+static FILE *telemetry_file = NULL;
+static int telemetry_games = 0;
+
+uint64_t monotonic_time() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+bool telemetry_start(int fd) {
+  telemetry_file = fdopen(fd, "w");
+
+  if (telemetry_file != NULL) {
+    atomic_store(&telemetry_running, true);
+
+    if (pthread_create(&telemetry_writer, NULL, drain_telemetry, NULL) == 0) {
+      telemetry_enabled = true;
+    } else {
+      fclose(telemetry_file);
+      telemetry_file = NULL;
+    }
+  }
+
+  return telemetry_enabled;
+}
+
+void telemetry_stop() {
+  if (!telemetry_enabled) return;
+
+  telemetry_enabled = false;
+  atomic_store(&telemetry_running, false);
+  pthread_join(telemetry_writer, NULL);
+
+  fclose(telemetry_file);
+  telemetry_file = NULL;
+}
+
+void begin_telemetry(GameInfo_t *game) {
+  game->stats.game_id = ++telemetry_games;
+  game->stats.started = monotonic_time() - game->stats.resumed;
+}
+
+void count_action(GameInfo_t *game, UserAction_t action) {
+  Telemetry_t *stats = &game->stats;
+
+  if (action == Pause) {
+    stats->paused_since = monotonic_time();
+  } else if (action == Start && game->state == PauseState) {
+    stats->paused_time += monotonic_time() - stats->paused_since;
+  } else if (action >= Left && action <= Action) {
+    stats->actions++;
+    stats->hard_drops += (action == Down) ? 1 : 0;
+  }
+}
+
+void count_locked_piece(GameInfo_t *game, const GameEvent_t *event) {
+  Telemetry_t *stats = &game->stats;
+
+  stats->pieces++;
+  stats->cleared[event->lines]++;
+  stats->stack_height_sum += event->stack_height;
+
+  if (telemetry_enabled) {
+    TelemetryRecord_t record = {TelemetryPiece, monotonic_time(),
+                                event->score, event->level, event->lines,
+                                event->stack_height, *stats};
+    push_telemetry(&record);
+  }
+}
+
+void finish_telemetry(GameInfo_t *game) {
+  Telemetry_t *stats = &game->stats;
+
+  if (game->state == PauseState) {
+    stats->paused_time += monotonic_time() - stats->paused_since;
+  }
+
+  if (telemetry_enabled) {
+    TelemetryRecord_t record = {TelemetrySummary, monotonic_time(),
+                                game->score, game->level, 0, 0, *stats};
+    push_telemetry(&record);
+  }
+}
+
+int stack_height(GameInfo_t *game) {
+  int height = 0;
+
+  for (int row = 0; row < BOARD_HEIGHT && height == 0; row++) {
+    if (!line_is_empty(game, row)) {
+      height = BOARD_HEIGHT - row;
+    }
+  }
+
+  return height;
+}
+
+void push_telemetry(const TelemetryRecord_t *record) {
+  size_t head = atomic_load_explicit(&telemetry_head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&telemetry_tail, memory_order_acquire);
+
+  if (head - tail == TELEMETRY_RING_SIZE) {
+    atomic_fetch_add_explicit(&telemetry_dropped, 1, memory_order_relaxed);
+    return;
+  }
+
+  telemetry_ring[head % TELEMETRY_RING_SIZE] = *record;
+  atomic_store_explicit(&telemetry_head, head + 1, memory_order_release);
+}
+
+void *drain_telemetry(void *arg) {
+  (void)arg;
+  struct timespec idle = {0, 1000000};
+  bool running = true;
+
+  while (running) {
+    running = atomic_load(&telemetry_running);
+
+    size_t head = atomic_load_explicit(&telemetry_head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&telemetry_tail, memory_order_relaxed);
+
+    if (head == tail) {
+      fflush(telemetry_file);
+      if (running) nanosleep(&idle, NULL);
+      continue;
+    }
+
+    for (; tail != head; tail++) {
+      write_telemetry(&telemetry_ring[tail % TELEMETRY_RING_SIZE]);
+      atomic_store_explicit(&telemetry_tail, tail + 1, memory_order_release);
+    }
+    running = true;
+  }
+
+  return NULL;
+}
+
+void write_telemetry(const TelemetryRecord_t *record) {
+  const Telemetry_t *stats = &record->stats;
+  double elapsed = (record->time - stats->started) / 1e9;
+
+  if (record->kind == TelemetryPiece) {
+    fprintf(telemetry_file,
+            "{\"type\":\"piece\",\"game\":%d,\"piece\":%d,\"t\":%.3f,"
+            "\"lines\":%d,\"stack_height\":%d,\"score\":%d,\"level\":%d}\n",
+            stats->game_id, stats->pieces, elapsed, record->lines,
+            record->stack_height, record->score, record->level);
+    return;
+  }
+
+  double paused = stats->paused_time / 1e9;
+  double active = elapsed > paused ? elapsed - paused : 0;
+  int pieces = stats->pieces;
+
+  fprintf(telemetry_file,
+          "{\"type\":\"summary\",\"game\":%d,\"duration\":%.3f,"
+          "\"paused\":%.3f,\"pieces\":%d,\"pieces_per_second\":%.3f,"
+          "\"actions_per_minute\":%.1f,\"singles\":%d,\"doubles\":%d,"
+          "\"triples\":%d,\"tetrises\":%d,\"average_stack_height\":%.2f,"
+          "\"hard_drops\":%d,\"dropped_frames\":%ld,\"score\":%d,\"level\":%d,"
+          "\"dropped\":%lu}\n",
+          stats->game_id, elapsed, paused, pieces,
+          active > 0 ? pieces / active : 0.0,
+          active > 0 ? stats->actions * 60.0 / active : 0.0,
+          stats->cleared[1], stats->cleared[2], stats->cleared[3],
+          stats->cleared[4],
+          pieces > 0 ? (double)stats->stack_height_sum / pieces : 0.0,
+          stats->hard_drops, stats->dropped_frames, record->score,
+          record->level,
+          (unsigned long)atomic_load(&telemetry_dropped));
+}
@@ -9,129 +9,118 @@ void tetris() {
 }
 
 void prepare(GameInfo_t *game) {
-  reset(game);
+  prepare_game(game, (unsigned int)monotonic_time());
+  if (save_enabled) load_game(game, SAVE_FILE);
   init_ncurses();
 
-  game->field = create_field(FIELD_HEIGHT, FIELD_WIDTH);
-  game->next = create_field(NEXT_HEIGHT, NEXT_WIDTH);
-
-  generate_random_figure(&game->figure);
-  generate_random_figure(&game->next_figure);
-  display_next_figure(game);
-
   set_high_score_in_game(game);
 
   display_initial_screen(game);
 }
 
 void start(GameInfo_t *game) {
+  begin_telemetry(game);
+  uint64_t frame = monotonic_time();
+  bool changed = true;
+
   while (!game->exit) {
     updateCurrentState(game);
-    print_game(game);
+
+    TRACE_BEGIN("drain_events");
+    changed = drain_events(game) > 0 || changed;
+    TRACE_END("drain_events");
+
+    if (changed) print_game(game);
+    changed = false;
+
+    TRACE_BEGIN("wait_next_frame");
+    frame = wait_next_frame(frame, &game->stats.dropped_frames);
+    TRACE_END("wait_next_frame");
   }
 }
 
 void finish(GameInfo_t *game) {
-  if (game->over) {
+  finish_telemetry(game);
+
+  if (game->state == GameOverState) {
+    if (save_enabled) remove(SAVE_FILE);
     display_game_over();
+  } else if (save_enabled && game->state != StartState) {
+    save_game(game, SAVE_FILE);
   }
 
-  free_field(game->field, FIELD_HEIGHT);
-  free_field(game->next, NEXT_HEIGHT);
   endwin();
 }
 
+void prepare_game(GameInfo_t *game, unsigned int seed) {
+  reset(game);
+  game->seed = (seed != 0) ? seed : 1;
+
+  generate_random_figure(&game->figure, &game->seed);
+  generate_random_figure(&game->next_figure, &game->seed);
+  display_next_figure(game);
+}
+
 void reset(GameInfo_t *game) {
-  game->field = NULL;
-  game->next = NULL;
+  memset(game->field, EMPTY_CELL, sizeof(game->field));
+  memset(game->next, EMPTY_CELL, sizeof(game->next));
   game->score = 0;
   game->high_score = 0;
   game->level = 1;
-  game->speed = 275;
-  game->pause = 0;
-  game->over = 0;
+  game->gravity = level_gravity[0];
+  game->gravity_progress = 0;
+  game->state = StartState;
   game->exit = 0;
+  game->headless = 0;
+  game->seed = 1;
+  memset(&game->stats, 0, sizeof(game->stats));
+  game->event_count = 0;
+  game->dropped_events = 0;
 }
 
-int **create_field(int height, int width) {
-  int **field = allocate_field(height, width);
-  fill_field(field, height, width);
-
-  return field;
-}
+void updateCurrentState(GameInfo_t *game) {
+  UserAction_t action;
 
-int **allocate_field(int height, int width) {
-  int **field = (int **)malloc(height * sizeof(int *));
+  TRACE_BEGIN("updateCurrentState");
 
-  if (field != NULL) {
-    for (int i = 0; i < height; i++) {
-      field[i] = (int *)malloc(width * sizeof(int));
-    }
-  }
+  TRACE_BEGIN("userInput");
+  userInput(&action);
+  TRACE_END("userInput");
 
-  return field;
-}
+  update_state(game, action);
 
-void fill_field(int **field, int height, int width) {
-  for (int row = 0; row < height; row++) {
-    for (int column = 0; column < width; column++) {
-      put_specific_symbol_in_field(field, row, column, height, width);
-    }
-  }
+  TRACE_END("updateCurrentState");
 }
 
-void put_specific_symbol_in_field(int **field, int row, int column, int height,
-                                  int width) {
-  bool is_top_row = (row == 0);
-  bool is_bottom_row = (row == height - 1);
-  bool is_left_column = (column == 0);
-  bool is_right_column = (column == width - 1);
-
-  if (is_top_row || is_bottom_row) {
-    field[row][column] = H_LINE;
-  } else if (is_left_column || is_right_column) {
-    field[row][column] = V_LINE;
-  } else {
-    field[row][column] = SPACE;
-  }
+void generate_random_figure(Figure_t *figure, unsigned int *seed) {
+  figure->x = HORISONTAL_FIELD_MIDDLE;
+  figure->y = 0;
+  set_random_shape_to(figure, seed);
 }
 
-void free_field(int **field, int height) {
-  for (int i = 0; i < height; i++) {
-    free(field[i]);
-  }
-
-  free(field);
+void set_random_shape_to(Figure_t *figure, unsigned int *seed) {
+  int type = next_random(seed) % LEN(figures);
+  memcpy(figure->shape, figures[type], sizeof(figures[type]));
+  figure->type = (Cell_t)(type + 1);
 }
 
-void updateCurrentState(GameInfo_t *game) {
-  UserAction_t action;
+unsigned int next_random(unsigned int *seed) {
+  unsigned int state = *seed;
 
-  userInput(&action);
-  handle_user_input(game, action);
-  gravity(game);
-  check_game_over(game);
-}
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
 
-void generate_random_figure(Figure_t *figure) {
-  figure->x = HORISONTAL_FIELD_MIDDLE;
-  figure->y = 1;
-  set_random_shape_to(figure);
-}
-
-void set_random_shape_to(Figure_t *figure) {
-  int type = clock() % 7;
-  memcpy(figure->shape, figures[type], sizeof(figures[type]));
+  return *seed = state;
 }
 
 void display_next_figure(GameInfo_t *game) {
   int(*shape)[SHAPE_SIZE] = game->next_figure.shape;
-  int start_x = (NEXT_WIDTH - SHAPE_SIZE) / 2;
-  int start_y = (NEXT_HEIGHT - SHAPE_SIZE) / 2;
 
   for (int i = 0; i < SHAPE_SIZE; i++) {
     for (int j = 0; j < SHAPE_SIZE; j++) {
-      game->next[start_y + i][start_x + j] = shape[i][j];
+      game->next[i][j] = (shape[i][j] != SPACE) ? game->next_figure.type
+                                                : EMPTY_CELL;
     }
   }
 }
@@ -177,12 +166,13 @@ void handle_user_input(GameInfo_t *game, UserAction_t action) {
 }
 
 void handle_user_action(GameInfo_t *game, UserAction_t action) {
+  count_action(game, action);
+
   switch (action) {
     case Start:
-      game->pause = 0;
       break;
     case Pause:
-      game->pause = 1;
+      game->state = PauseState;
       break;
     case Terminate:
       game->exit = 1;
@@ -195,6 +185,7 @@ void handle_user_action(GameInfo_t *game, UserAction_t action) {
       break;
     case Down:
       move_figure_down(game);
+      game->state = AttachingState;
       break;
     case Action:
       rotate_figure(game);
@@ -203,35 +194,54 @@ void handle_user_action(GameInfo_t *game, UserAction_t action) {
 }
 
 void move_figure_left(GameInfo_t *game) {
-  if (game->pause) return;
-
-  game->figure.x -= can_move(*game, LEFT) ? 1 : 0;
+  if (can_move(game, LEFT)) {
+    game->figure.x -= 1;
+    emit_event(game, EventMoved, 0, 0);
+  }
 }
 
 void move_figure_right(GameInfo_t *game) {
-  if (game->pause) return;
-
-  game->figure.x += can_move(*game, RIGHT) ? 1 : 0;
+  if (can_move(game, RIGHT)) {
+    game->figure.x += 1;
+    emit_event(game, EventMoved, 0, 0);
+  }
 }
 
 void move_figure_down(GameInfo_t *game) {
-  if (game->pause) return;
+  int distance = drop_distance(game);
 
-  while (can_move(*game, DOWN)) {
-    remove_figure(game);
-    game->figure.y += 1;
-    place_figure(game);
+  if (distance > 0) {
+    game->figure.y += distance;
+    emit_event(game, EventMoved, 0, 0);
   }
 }
 
-void rotate_figure(GameInfo_t *game) {
-  if (game->pause) return;
+int drop_distance(GameInfo_t *game) {
+  Figure_t *figure = &game->figure;
+  Board_t board;
+  uint8_t mask[SHAPE_SIZE];
+
+  board_from_field(game, &board);
+  shape_to_mask(figure->shape, mask);
+
+  for (int i = 0; i < SHAPE_SIZE; i++) {
+    int row = figure->y + i;
+
+    if (row >= 0 && row < BOARD_HEIGHT) {
+      board.rows[row] &= (uint8_t)~shift_mask_row(mask[i], figure->x);
+    }
+  }
+
+  return board_drop(&board, mask, figure->x, figure->y) - figure->y;
+}
 
+void rotate_figure(GameInfo_t *game) {
   int temp[SHAPE_SIZE][SHAPE_SIZE];
   fill_and_rotate_clockwise(game, temp);
 
   if (can_place(game, temp)) {
     memcpy(game->figure.shape, temp, sizeof(temp));
+    emit_event(game, EventRotated, 0, 0);
   }
 }
 
@@ -253,9 +263,7 @@ bool can_place(GameInfo_t *game, int rotated_shape[SHAPE_SIZE][SHAPE_SIZE]) {
         int new_x = game->figure.x + j;
         int new_y = game->figure.y + i;
 
-        if ((new_x < 0 || new_x >= FIELD_WIDTH - 1) ||
-            (new_y < 0 || new_y >= FIELD_HEIGHT - 1) ||
-            game->field[new_y][new_x] != SPACE) {
+        if (!cell_is_free(game, new_y, new_x)) {
           ability = false;
         }
       }
@@ -266,35 +274,47 @@ bool can_place(GameInfo_t *game, int rotated_shape[SHAPE_SIZE][SHAPE_SIZE]) {
 }
 
 void gravity(GameInfo_t *game) {
-  if (game->pause) return;
+  int rows = gravity_rows(game);
+  int distance = (rows > 0) ? drop_distance(game) : 0;
+
+  game->state = MovingState;
 
-  if (can_move(*game, DOWN)) {
+  if (rows > 0 && distance == 0) {
+    game->state = AttachingState;
+  } else if (rows > 0) {
     remove_figure(game);
-    game->figure.y += 1;
+    game->figure.y += (rows < distance) ? rows : distance;
     place_figure(game);
-  } else {
-    place_figure(game);
-    remove_completed_lines(game);
-    drop_next_figure(game);
+    emit_event(game, EventMoved, 0, 0);
   }
 }
 
+int gravity_rows(GameInfo_t *game) {
+  game->gravity_progress += game->gravity;
+
+  int rows = (int)(game->gravity_progress / GRAVITY_ONE);
+  game->gravity_progress %= GRAVITY_ONE;
+
+  return rows;
+}
+
 void drop_next_figure(GameInfo_t *game) {
   game->figure = game->next_figure;
-  generate_random_figure(&game->next_figure);
+  game->gravity_progress = 0;
+  generate_random_figure(&game->next_figure, &game->seed);
   display_next_figure(game);
 }
 
-bool can_move(GameInfo_t game, int direction) {
+bool can_move(const GameInfo_t *game, int direction) {
   bool is_free = true;
-  int(*shape)[SHAPE_SIZE] = game.figure.shape;
+  Figure_t phantom = game->figure;
 
-  make_phantom_figure(&game, direction);
+  make_phantom_figure(&phantom, direction);
 
   for (int i = 0; i < SHAPE_SIZE; i++) {
     for (int j = 0; j < SHAPE_SIZE; j++) {
-      if (shape[i][j] != SPACE) {
-        check_space_around(game, &is_free, i, j);
+      if (phantom.shape[i][j] != SPACE) {
+        check_space_around(game, &phantom, &is_free, i, j);
       }
     }
   }
@@ -302,28 +322,32 @@ bool can_move(GameInfo_t game, int direction) {
   return is_free;
 }
 
-void make_phantom_figure(GameInfo_t *game, int direction) {
-  remove_figure(game);
-
+void make_phantom_figure(Figure_t *figure, int direction) {
   if (direction == RIGHT) {
-    game->figure.x += 1;
+    figure->x += 1;
   } else if (direction == LEFT) {
-    game->figure.x -= 1;
+    figure->x -= 1;
   } else if (direction == DOWN) {
-    game->figure.y += 1;
+    figure->y += 1;
   }
 }
 
-void check_space_around(GameInfo_t game, bool *is_free, int i, int j) {
-  int new_y = game.figure.y + i;
-  int new_x = game.figure.x + j;
+void check_space_around(const GameInfo_t *game, const Figure_t *figure,
+                        bool *is_free, int i, int j) {
+  int new_y = figure->y + i;
+  int new_x = figure->x + j;
 
-  if (game.field[new_y][new_x] != SPACE) {
+  if (!cell_is_free(game, new_y, new_x)) {
     *is_free = false;
   }
 }
 
-void remove_completed_lines(GameInfo_t *game) {
+bool cell_is_free(const GameInfo_t *game, int row, int column) {
+  return row >= 0 && row < BOARD_HEIGHT && column >= 0 &&
+         column < BOARD_WIDTH && game->field[row][column] == EMPTY_CELL;
+}
+
+int remove_completed_lines(GameInfo_t *game) {
   int lines[LINES_NUMBER];
   reset_lines_array(lines);
 
@@ -334,8 +358,12 @@ void remove_completed_lines(GameInfo_t *game) {
     shift_blocks_down(game);
 
     update_score(game, lines);
+    emit_event(game, EventLinesCleared, count_filled_lines(lines),
+               lines_to_rows(lines));
     update_level(game);
   }
+
+  return count_filled_lines(lines);
 }
 
 void reset_lines_array(int lines[]) {
@@ -347,7 +375,7 @@ void reset_lines_array(int lines[]) {
 void find_completed_line(GameInfo_t *game, int lines[]) {
   int index = 0;
 
-  for (int row = 1; row < FIELD_HEIGHT - 1; row++) {
+  for (int row = 0; row < BOARD_HEIGHT; row++) {
     if (line_is_full(game, row)) {
       lines[index++] = row;
     }
@@ -355,14 +383,13 @@ void find_completed_line(GameInfo_t *game, int lines[]) {
 }
 
 bool line_is_full(GameInfo_t *game, int row) {
-  int borders = 2;
   int count = 0;
 
-  for (int column = 1; column < FIELD_WIDTH - 1; column++) {
-    count += game->field[row][column] != SPACE ? 1 : 0;
+  for (int column = 0; column < BOARD_WIDTH; column++) {
+    count += game->field[row][column] != EMPTY_CELL ? 1 : 0;
   }
 
-  return (count == (FIELD_WIDTH - borders));
+  return (count == BOARD_WIDTH);
 }
 
 bool lines_were_found(int lines[]) {
@@ -387,13 +414,11 @@ void clear_founded_lines(GameInfo_t *game, int lines[]) {
 void clear_line(GameInfo_t *game, int line) {
   if (line == -1) return;
 
-  for (int column = 1; column < FIELD_WIDTH - 1; column++) {
-    game->field[line][column] = SPACE;
-  }
+  memset(game->field[line], EMPTY_CELL, BOARD_WIDTH);
 }
 
 void shift_blocks_down(GameInfo_t *game) {
-  for (int row = FIELD_HEIGHT - 2; row > 0; row--) {
+  for (int row = BOARD_HEIGHT - 1; row > 0; row--) {
     if (line_is_empty(game, row)) {
       int non_empty_line = find_first_non_empty_line_above(game, row);
 
@@ -408,8 +433,8 @@ void shift_blocks_down(GameInfo_t *game) {
 bool line_is_empty(GameInfo_t *game, int row) {
   int count = 0;
 
-  for (int column = 1; column < FIELD_WIDTH - 1; column++) {
-    count += game->field[row][column] != SPACE ? 1 : 0;
+  for (int column = 0; column < BOARD_WIDTH; column++) {
+    count += game->field[row][column] != EMPTY_CELL ? 1 : 0;
   }
 
   return (count == 0);
@@ -418,7 +443,7 @@ bool line_is_empty(GameInfo_t *game, int row) {
 int find_first_non_empty_line_above(GameInfo_t *game, int start_row) {
   int found_row = -1;
 
-  for (int row = start_row - 1; row > 0; row--) {
+  for (int row = start_row - 1; row >= 0; row--) {
     if (!line_is_empty(game, row)) {
       found_row = row;
       break;
@@ -429,9 +454,7 @@ int find_first_non_empty_line_above(GameInfo_t *game, int start_row) {
 }
 
 void copy_line(GameInfo_t *game, int dest_row, int src_row) {
-  for (int column = 1; column < FIELD_WIDTH - 1; column++) {
-    game->field[dest_row][column] = game->field[src_row][column];
-  }
+  memcpy(game->field[dest_row], game->field[src_row], BOARD_WIDTH);
 }
 
 void update_score(GameInfo_t *game, int lines[]) {
@@ -450,12 +473,24 @@ void update_score(GameInfo_t *game, int lines[]) {
       break;
   }
 
-  if (new_high_score(game)) {
+  if (new_high_score(game) && !game->headless) {
     game->high_score = game->score;
     save_high_score(game);
   }
 }
 
+uint32_t lines_to_rows(int lines[]) {
+  uint32_t rows = 0;
+
+  for (int i = 0; i < LINES_NUMBER; i++) {
+    if (lines[i] != -1) {
+      rows |= 1u << lines[i];
+    }
+  }
+
+  return rows;
+}
+
 int count_filled_lines(int lines[]) {
   int count = 0;
 
@@ -483,36 +518,31 @@ void save_high_score(GameInfo_t *game) {
 }
 
 void update_level(GameInfo_t *game) {
-  int score = game->score;
-
-  if (score >= 6000) {
-    game->level = 10;
-    game->speed = 50;
-  } else if (score >= 5400) {
-    game->level = 9;
-    game->speed = 75;
-  } else if (score >= 4800) {
-    game->level = 8;
-    game->speed = 100;
-  } else if (score >= 4200) {
-    game->level = 7;
-    game->speed = 125;
-  } else if (score >= 3600) {
-    game->level = 6;
-    game->speed = 150;
-  } else if (score >= 3000) {
-    game->level = 5;
-    game->speed = 175;
-  } else if (score >= 2400) {
-    game->level = 4;
-    game->speed = 200;
-  } else if (score >= 1800) {
-    game->level = 3;
-    game->speed = 225;
-  } else if (score >= 1200) {
-    game->level = 2;
-    game->speed = 250;
+  int level = game->score / LEVEL_SCORE;
+
+  if (level > LEVEL_MAX) level = LEVEL_MAX;
+  if (level > game->level) {
+    game->level = level;
+    emit_event(game, EventLevelUp, 0, 0);
   }
+
+  game->gravity = level_gravity[game->level - 1];
+}
+
+uint64_t wait_next_frame(uint64_t deadline, long *dropped) {
+  uint64_t now = monotonic_time();
+  deadline += FRAME_TIME;
+
+  if (deadline < now) {
+    *dropped += (long)((now - deadline) / FRAME_TIME) + 1;
+    deadline = now;
+  }
+
+  struct timespec wake = {(time_t)(deadline / 1000000000ULL),
+                          (long)(deadline % 1000000000ULL)};
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+
+  return deadline;
 }
 
 void remove_figure(GameInfo_t *game) {
@@ -530,7 +560,7 @@ void remove_figure(GameInfo_t *game) {
 void remove_elem(GameInfo_t *game, int i, int j) {
   int y = game->figure.y + i;
   int x = game->figure.x + j;
-  game->field[y][x] = SPACE;
+  game->field[y][x] = EMPTY_CELL;
 }
 
 void place_figure(GameInfo_t *game) {
@@ -548,18 +578,12 @@ void place_figure(GameInfo_t *game) {
 void place_elem(GameInfo_t *game, int i, int j) {
   int y = game->figure.y + i;
   int x = game->figure.x + j;
-  game->field[y][x] = game->figure.shape[i][j];
+  game->field[y][x] = game->figure.type;
 }
 
 void check_game_over(GameInfo_t *game) {
-  int max_field_row = 1;
-  int max_spawn_row = 2;
-
-  for (int cell = 1; cell < FIELD_WIDTH - 1; cell++) {
-    if (game->field[max_field_row][cell] != SPACE &&
-        (game->figure.y != max_spawn_row || can_move(*game, DOWN))) {
-      game->over = 1;
-      game->exit = 1;
-    }
+  if (!can_place(game, game->figure.shape)) {
+    game->state = GameOverState;
+    emit_event(game, EventGameOver, 0, 0);
   }
 }
@@ -1,16 +1,31 @@
 #ifndef TETRIS_H
 #define TETRIS_H
 
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <assert.h>
+#include <fcntl.h>
+#include <malloc.h>
 #include <ncurses.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 #define FIELD_WIDTH 10
 #define FIELD_HEIGHT 20
-#define HORISONTAL_FIELD_MIDDLE (FIELD_WIDTH / 2 - 2)
+#define BOARD_WIDTH (FIELD_WIDTH - 2)
+#define BOARD_HEIGHT (FIELD_HEIGHT - 2)
+#define HORISONTAL_FIELD_MIDDLE (BOARD_WIDTH / 2 - 2)
 
 #define NEXT_WIDTH 6
 #define NEXT_HEIGHT 6
@@ -22,6 +37,8 @@
 #define H_LINE 61
 #define V_LINE 124
 #define SPACE 32
+#define BLOCK 42
+#define EMPTY_CELL 0
 
 #define PLACE true
 #define REMOVE false
@@ -30,16 +47,103 @@
 #define LEFT 1
 #define DOWN 2
 
-#define LINES_NUMBER (FIELD_HEIGHT - 2)
+#define FRAME_RATE 60
+#define FRAME_TIME (1000000000ULL / FRAME_RATE)
+
+#define LEVEL_MAX 20
+#define LEVEL_SCORE 600
+#define GRAVITY_ONE 65536
+#define GRAVITY_MS(ms) (GRAVITY_ONE * 1000 / (FRAME_RATE * (ms)))
+
+#define LINES_NUMBER BOARD_HEIGHT
+#define BOARD_FULL_ROW ((1u << BOARD_WIDTH) - 1)
+#define MAX_PLACEMENTS (SHAPE_SIZE * (BOARD_WIDTH + 1))
+#define BOT_MAX_ACTIONS (SHAPE_SIZE + BOARD_WIDTH + 1)
+#define BOT_INPUT_FRAMES 4
+
+#define PUZZLE_MAX_PIECES 64
+#define PUZZLE_MAX_NODES (1 << 22)
+#define PUZZLE_CHUNK 64
+#define PUZZLE_FULL UINT32_MAX
+#define PUZZLE_DUPLICATE (UINT32_MAX - 1)
+#define PUZZLE_WRITING (UINT32_MAX - 2)
+
+#define SAVE_FILE "brick_game/tetris/save.bin"
+#define SAVE_MAGIC "TSAV"
+#define SAVE_VERSION 3
+#define SAVE_HEADER_SIZE 12
+#define SAVE_FIELD_SIZE (BOARD_HEIGHT * BOARD_WIDTH / 2)
+#define SAVE_MEMBER_SIZE(type, member) sizeof(((type *)0)->member)
+#define SAVE_PAYLOAD_SIZE                                                      \
+  (SAVE_FIELD_SIZE + 2 * sizeof(uint16_t) + 2 * sizeof(int8_t) +               \
+   SAVE_MEMBER_SIZE(GameInfo_t, figure.type) +                                 \
+   SAVE_MEMBER_SIZE(GameInfo_t, next_figure.type) +                            \
+   SAVE_MEMBER_SIZE(GameInfo_t, seed) +                                        \
+   SAVE_MEMBER_SIZE(GameInfo_t, score) +                                       \
+   SAVE_MEMBER_SIZE(GameInfo_t, level) + sizeof(uint8_t) + sizeof(uint64_t) +  \
+   SAVE_MEMBER_SIZE(Telemetry_t, paused_time) +                                \
+   SAVE_MEMBER_SIZE(Telemetry_t, pieces) +                                     \
+   SAVE_MEMBER_SIZE(Telemetry_t, actions) +                                    \
+   SAVE_MEMBER_SIZE(Telemetry_t, hard_drops) +                                 \
+   SAVE_MEMBER_SIZE(Telemetry_t, cleared) +                                    \
+   SAVE_MEMBER_SIZE(Telemetry_t, stack_height_sum))
+
+#define WORKERS_MAX_THREADS 256
+
+#define BOOK_FILE "brick_game/tetris/book.bin"
+#define BOOK_MAGIC "TBOK"
+#define BOOK_VERSION 1
+#define BOOK_HEADER_SIZE 20
+#define BOOK_DEPTH 4
+#define BOOK_MAX_DEPTH 8
+#define BOOK_BUCKET_SIZE 4
+#define BOOK_MAX_BUCKET 64
+#define BOOK_MAX_DISPLACEMENT (1u << 20)
+#define BOOK_CHUNK 64
+
+#define SOAK_SAMPLES 20
+#define SOAK_SUB_BUCKETS 64
+#define SOAK_EXPONENTS 40
+#define SOAK_BUCKETS (SOAK_SUB_BUCKETS * SOAK_EXPONENTS)
+#define SOAK_P99_DRIFT 2
+#define SOAK_P99_TOLERANCE 20000
+#define SOAK_DRIFT_SAMPLES 2
+#define SOAK_MIN_TICKS 1000
+#define SOAK_WARMUP_SAMPLES 1
+
+#define DASHBOARD_MAX_BOARDS 256
+#define DASHBOARD_FPS 30
+#define DASHBOARD_TILE_WIDTH (BOARD_WIDTH + 3)
+#define DASHBOARD_TILE_HEIGHT (BOARD_HEIGHT / 2 + 3)
 
 #define LEN(array) (sizeof(array) / sizeof(array[0]))
 
+#define TELEMETRY_RING_SIZE 4096
+
+#define EVENT_CAPACITY 64
+#define EVENT_MAX_HANDLERS 8
+
+#define TRACE_CAPACITY (1 << 21)
+#define TRACE_BEGIN(name)                        \
+  do {                                           \
+    if (trace_enabled) trace_event((name), 'B'); \
+  } while (0)
+#define TRACE_END(name)                          \
+  do {                                           \
+    if (trace_enabled) trace_event((name), 'E'); \
+  } while (0)
+
+typedef uint8_t Cell_t;
+
 typedef struct {
   int x;
   int y;
+  Cell_t type;
   int shape[4][4];
 } Figure_t;
 extern const int figures[7][4][4];
+extern const char figure_names[];
+extern const uint32_t level_gravity[LEVEL_MAX];
 
 typedef enum {
   Start,
@@ -51,35 +155,248 @@ typedef enum {
   Action
 } UserAction_t;
 
+typedef enum {
+  StartState,
+  SpawnState,
+  MovingState,
+  ShiftingState,
+  AttachingState,
+  PauseState,
+  GameOverState
+} GameState_t;
+
+typedef struct {
+  int game_id;
+  int pieces;
+  int actions;
+  int hard_drops;
+  int cleared[SHAPE_SIZE + 1];
+  int64_t stack_height_sum;
+  uint64_t started;
+  uint64_t resumed;
+  uint64_t paused_since;
+  uint64_t paused_time;
+  long dropped_frames;
+} Telemetry_t;
+
+typedef enum {
+  EventSpawned,
+  EventMoved,
+  EventRotated,
+  EventLocked,
+  EventLinesCleared,
+  EventLevelUp,
+  EventGameOver
+} EventKind_t;
+extern const char *event_names[];
+
 typedef struct {
-  int **field;
-  int **next;
+  EventKind_t kind;
+  Cell_t piece;
+  int x;
+  int y;
+  int lines;
+  uint32_t rows;
+  int stack_height;
+  int score;
+  int level;
+} GameEvent_t;
+
+typedef struct {
+  Cell_t field[BOARD_HEIGHT][BOARD_WIDTH];
+  Cell_t next[SHAPE_SIZE][SHAPE_SIZE];
   Figure_t figure;
   Figure_t next_figure;
   int score;
   int high_score;
   int level;
-  int speed;
-  int pause;
-  int over;
+  uint32_t gravity;
+  uint32_t gravity_progress;
+  GameState_t state;
   int exit;
+  int headless;
+  unsigned int seed;
+  Telemetry_t stats;
+  GameEvent_t events[EVENT_CAPACITY];
+  int event_count;
+  long dropped_events;
 } GameInfo_t;
 
+typedef void (*EventHandler_t)(GameInfo_t *game, const GameEvent_t *event,
+                               void *context);
+
+typedef struct {
+  EventHandler_t handler;
+  void *context;
+} EventSubscriber_t;
+
+typedef struct {
+  const char *name;
+  void (*handler)(GameInfo_t *game, UserAction_t action);
+  bool transient;
+} State_t;
+extern const State_t game_states[];
+
+typedef enum { TelemetryPiece, TelemetrySummary } TelemetryKind_t;
+
+typedef struct {
+  TelemetryKind_t kind;
+  uint64_t time;
+  int score;
+  int level;
+  int lines;
+  int stack_height;
+  Telemetry_t stats;
+} TelemetryRecord_t;
+extern bool telemetry_enabled;
+
+typedef struct {
+  uint8_t rows[LINES_NUMBER];
+} Board_t;
+
+typedef struct {
+  int rotation;
+  int x;
+  int y;
+  uint8_t mask[SHAPE_SIZE];
+} Placement_t;
+
+typedef struct {
+  UserAction_t actions[BOT_MAX_ACTIONS];
+  int count;
+  int next;
+  int piece;
+  int wait;
+} Bot_t;
+
+typedef struct {
+  long buckets[SOAK_BUCKETS];
+  long count;
+  uint64_t max;
+} LatencyHistogram_t;
+
+typedef struct {
+  uint64_t duration;
+  uint64_t interval;
+  uint64_t next_sample;
+  uint64_t simulated;
+  long games;
+  long pieces;
+  int samples;
+  long baseline_rss;
+  uint64_t baseline_p99;
+  long baseline_heap;
+  int drifting;
+  bool failed;
+  LatencyHistogram_t latency;
+} SoakState_t;
+
+typedef struct {
+  GameInfo_t game;
+  Bot_t bot;
+  uint64_t due;
+  long games;
+  bool changed;
+  bool drawn;
+} DashboardBoard_t;
+
+typedef struct {
+  Board_t board;
+  uint8_t current;
+  uint8_t next;
+} BookKey_t;
+
+typedef struct {
+  BookKey_t key;
+  uint8_t rotation;
+  int8_t x;
+} BookEntry_t;
+
+typedef struct {
+  const uint8_t *data;
+  size_t size;
+  const uint32_t *displacements;
+  const BookEntry_t *entries;
+  uint32_t buckets;
+  uint32_t slots;
+  long lookups;
+  long hits;
+} OpeningBook_t;
+extern OpeningBook_t opening_book;
+
+typedef struct {
+  const BookKey_t *frontier;
+  uint32_t count;
+  BookEntry_t *entries;
+  BookKey_t *children;
+  atomic_uint next;
+} BookLevel_t;
+
+typedef struct {
+  uint32_t bucket;
+  uint32_t size;
+  uint32_t entry;
+} BookBucket_t;
+
+typedef struct {
+  Board_t board;
+  uint32_t parent;
+  uint8_t rotation;
+  int8_t x;
+} PuzzleNode_t;
+
+typedef struct {
+  PuzzleNode_t *nodes;
+  atomic_uint *table;
+  uint32_t capacity;
+  uint32_t table_mask;
+  atomic_uint count;
+  atomic_uint next;
+} PuzzleLevel_t;
+
+typedef struct {
+  Board_t board;
+  int pieces[PUZZLE_MAX_PIECES];
+  int count;
+  int depth;
+  PuzzleLevel_t levels[PUZZLE_MAX_PIECES + 1];
+  atomic_uint solution;
+  atomic_long states;
+  atomic_bool overflow;
+} Puzzle_t;
+
+typedef struct {
+  Puzzle_t *puzzle;
+  int depth;
+} PuzzleWorker_t;
+
+typedef struct {
+  const char *name;
+  char phase;
+  uint64_t timestamp;
+} TraceEvent_t;
+
+typedef struct TraceBuffer_t {
+  TraceEvent_t *events;
+  size_t count;
+  size_t dropped;
+  int thread_id;
+  struct TraceBuffer_t *next;
+} TraceBuffer_t;
+extern bool trace_enabled;
+extern bool save_enabled;
+
 // ------------------------------------------------------------LOGIC------------------------------------------------------------
 void tetris();
 void prepare(GameInfo_t *game);
 void start(GameInfo_t *game);
 void finish(GameInfo_t *game);
 void reset(GameInfo_t *game);
-int **create_field(int height, int width);
-int **allocate_field(int height, int width);
-void fill_field(int **field, int height, int width);
-void put_specific_symbol_in_field(int **field, int row, int column, int height,
-                                  int width);
-void free_field(int **field, int height);
+void prepare_game(GameInfo_t *game, unsigned int seed);
 void updateCurrentState(GameInfo_t *game);
-void generate_random_figure(Figure_t *figure);
-void set_random_shape_to(Figure_t *figure);
+void generate_random_figure(Figure_t *figure, unsigned int *seed);
+void set_random_shape_to(Figure_t *figure, unsigned int *seed);
+unsigned int next_random(unsigned int *seed);
 void display_next_figure(GameInfo_t *game);
 void userInput(UserAction_t *action);
 void handle_user_input(GameInfo_t *game, UserAction_t action);
@@ -87,16 +404,20 @@ void handle_user_action(GameInfo_t *game, UserAction_t action);
 void move_figure_left(GameInfo_t *game);
 void move_figure_right(GameInfo_t *game);
 void move_figure_down(GameInfo_t *game);
+int drop_distance(GameInfo_t *game);
 void rotate_figure(GameInfo_t *game);
 void fill_and_rotate_clockwise(GameInfo_t *game,
                                int temp[SHAPE_SIZE][SHAPE_SIZE]);
 bool can_place(GameInfo_t *game, int rotated_shape[SHAPE_SIZE][SHAPE_SIZE]);
 void gravity(GameInfo_t *game);
+int gravity_rows(GameInfo_t *game);
 void drop_next_figure(GameInfo_t *game);
-bool can_move(GameInfo_t game, int direction);
-void make_phantom_figure(GameInfo_t *game, int direction);
-void check_space_around(GameInfo_t game, bool *is_free, int i, int j);
-void remove_completed_lines(GameInfo_t *game);
+bool can_move(const GameInfo_t *game, int direction);
+void make_phantom_figure(Figure_t *figure, int direction);
+void check_space_around(const GameInfo_t *game, const Figure_t *figure,
+                        bool *is_free, int i, int j);
+bool cell_is_free(const GameInfo_t *game, int row, int column);
+int remove_completed_lines(GameInfo_t *game);
 void reset_lines_array(int lines[]);
 void find_completed_line(GameInfo_t *game, int lines[]);
 bool line_is_full(GameInfo_t *game, int row);
@@ -108,18 +429,32 @@ bool line_is_empty(GameInfo_t *game, int row);
 int find_first_non_empty_line_above(GameInfo_t *game, int start_row);
 void copy_line(GameInfo_t *game, int dest_row, int src_row);
 void update_score(GameInfo_t *game, int lines[]);
+uint32_t lines_to_rows(int lines[]);
 int count_filled_lines(int lines[]);
 bool new_high_score(GameInfo_t *game);
 void save_high_score(GameInfo_t *game);
 void update_level(GameInfo_t *game);
+uint64_t wait_next_frame(uint64_t deadline, long *dropped);
 void remove_figure(GameInfo_t *game);
 void remove_elem(GameInfo_t *game, int i, int j);
 void place_figure(GameInfo_t *game);
 void place_elem(GameInfo_t *game, int i, int j);
 void check_game_over(GameInfo_t *game);
 
+// ------------------------------------------------------------FSM------------------------------------------------------------
+void update_state(GameInfo_t *game, UserAction_t action);
+void start_state(GameInfo_t *game, UserAction_t action);
+void spawn_state(GameInfo_t *game, UserAction_t action);
+void moving_state(GameInfo_t *game, UserAction_t action);
+void shifting_state(GameInfo_t *game, UserAction_t action);
+void attaching_state(GameInfo_t *game, UserAction_t action);
+void pause_state(GameInfo_t *game, UserAction_t action);
+void game_over_state(GameInfo_t *game, UserAction_t action);
+
 // ------------------------------------------------------------CLI------------------------------------------------------------
 void init_ncurses();
+void init_colors();
+chtype cell_symbol(Cell_t cell);
 void print_game(GameInfo_t *game);
 void print_field(GameInfo_t *game);
 void print_high_score(GameInfo_t *game);
@@ -127,6 +462,7 @@ void print_score(GameInfo_t *game);
 int calculate_number_x(int number);
 void print_level(GameInfo_t *game);
 void print_next_field(GameInfo_t *game);
+void print_border(int top, int left, int height, int width);
 void print_menu();
 void set_high_score_in_game(GameInfo_t *game);
 int get_score_from_file(FILE *high_score_file);
@@ -137,4 +473,150 @@ void display_game_over();
 extern const char *game_over[];
 void print_centered(WINDOW *win, int row, const char *str);
 
+// ------------------------------------------------------------EVENTS------------------------------------------------------------
+void emit_event(GameInfo_t *game, EventKind_t kind, int lines, uint32_t rows);
+int drain_events(GameInfo_t *game);
+bool add_event_handler(EventHandler_t handler, void *context);
+void telemetry_event(GameInfo_t *game, const GameEvent_t *event, void *context);
+void trace_game_event(GameInfo_t *game, const GameEvent_t *event,
+                      void *context);
+
+// ------------------------------------------------------------TRACE------------------------------------------------------------
+void trace_start(const char *path);
+void trace_event(const char *name, char phase);
+TraceBuffer_t *register_trace_buffer();
+uint64_t trace_now();
+void trace_stop();
+void write_trace(const char *path);
+void write_trace_buffer(FILE *trace_file, TraceBuffer_t *buffer, bool *first);
+
+// ------------------------------------------------------------TELEMETRY------------------------------------------------------------
+uint64_t monotonic_time();
+bool telemetry_start(int fd);
+void telemetry_stop();
+void begin_telemetry(GameInfo_t *game);
+void count_action(GameInfo_t *game, UserAction_t action);
+void count_locked_piece(GameInfo_t *game, const GameEvent_t *event);
+void finish_telemetry(GameInfo_t *game);
+int stack_height(GameInfo_t *game);
+void push_telemetry(const TelemetryRecord_t *record);
+void *drain_telemetry(void *arg);
+void write_telemetry(const TelemetryRecord_t *record);
+
+// ------------------------------------------------------------BOARD------------------------------------------------------------
+void board_from_game(GameInfo_t *game, Board_t *board);
+void board_from_field(GameInfo_t *game, Board_t *board);
+void shape_to_mask(int shape[SHAPE_SIZE][SHAPE_SIZE], uint8_t mask[]);
+void rotate_mask(const uint8_t mask[], uint8_t rotated[]);
+bool board_fits(const Board_t *board, const uint8_t mask[], int x, int y);
+unsigned int shift_mask_row(uint8_t row, int x);
+int board_drop(const Board_t *board, const uint8_t mask[], int x, int y);
+void board_place(Board_t *board, const uint8_t mask[], int x, int y);
+int board_clear_lines(Board_t *board);
+bool board_is_empty(const Board_t *board);
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed);
+int find_placements(const Board_t *board, const uint8_t shape[],
+                    Placement_t placements[]);
+int add_placements(const Board_t *board, const uint8_t mask[], int rotation,
+                   Placement_t placements[], int count);
+bool placement_is_known(const Placement_t placements[], int count,
+                        const Placement_t *placement);
+
+// ------------------------------------------------------------BOT------------------------------------------------------------
+void start_bot(Bot_t *bot);
+UserAction_t bot_action(Bot_t *bot, GameInfo_t *game);
+void plan_bot_actions(Bot_t *bot, GameInfo_t *game);
+int bot_input_frames(const GameInfo_t *game);
+bool find_best_placement(GameInfo_t *game, Placement_t *best);
+bool best_board_placement(const Board_t *board, const uint8_t current[],
+                          const uint8_t next[], Placement_t *best);
+int pick_best_placement(const Board_t *board, const Placement_t placements[],
+                        int count, const uint8_t next[]);
+void land_placement(const Board_t *board, const uint8_t shape[],
+                    const Placement_t *target, uint32_t gravity,
+                    int input_frames, Placement_t *landed);
+bool route_step(const Board_t *board, Placement_t *piece, UserAction_t action);
+double best_followup_score(const Board_t *board, const uint8_t shape[],
+                           int lines);
+double evaluate_board(const Board_t *board, int lines);
+void queue_placement(Bot_t *bot, int x, const Placement_t *placement);
+
+// ------------------------------------------------------------SOAK------------------------------------------------------------
+int run_soak(double hours);
+void play_soak_game(SoakState_t *soak);
+void record_latency(LatencyHistogram_t *histogram, uint64_t nanoseconds);
+int latency_bucket(uint64_t nanoseconds);
+uint64_t latency_percentile(const LatencyHistogram_t *histogram,
+                            double percentile);
+void take_soak_sample(SoakState_t *soak);
+void check_soak_drift(SoakState_t *soak, long rss, long heap, uint64_t p99);
+long resident_memory();
+long heap_in_use();
+
+// ------------------------------------------------------------DASHBOARD------------------------------------------------------------
+int run_dashboard(int count);
+void start_dashboard_game(DashboardBoard_t *board, unsigned int seed);
+bool step_dashboard_board(DashboardBoard_t *board, uint64_t now);
+bool dashboard_board_changed(DashboardBoard_t *board);
+void print_dashboard_board(DashboardBoard_t *board, int top, int left);
+chtype dashboard_cell_symbol(Cell_t upper, Cell_t lower);
+void print_dashboard_status(int count, long frames, double fps);
+
+// ------------------------------------------------------------WORKERS------------------------------------------------------------
+void run_workers(void *(*work)(void *), void *argument, int threads);
+
+// ------------------------------------------------------------PUZZLE------------------------------------------------------------
+int run_puzzle(const char *path, int threads);
+bool load_puzzle(const char *path, Puzzle_t *puzzle);
+uint8_t read_puzzle_row(const char *line);
+void read_puzzle_pieces(Puzzle_t *puzzle, const char *line);
+int solve_puzzle(Puzzle_t *puzzle, int threads);
+bool allocate_puzzle_level(PuzzleLevel_t *level, uint32_t capacity);
+void expand_puzzle_level(Puzzle_t *puzzle, int depth, int threads);
+void *expand_puzzle_nodes(void *arg);
+int expand_puzzle_node(Puzzle_t *puzzle, PuzzleLevel_t *next, uint32_t parent,
+                       const Board_t *board, const uint8_t shape[]);
+uint32_t insert_puzzle_node(PuzzleLevel_t *level, const PuzzleNode_t *node);
+uint32_t append_puzzle_node(PuzzleLevel_t *level, uint32_t slot,
+                            const PuzzleNode_t *node);
+void figure_to_mask(int type, uint8_t mask[]);
+void print_puzzle_solution(Puzzle_t *puzzle, int depth);
+int leftmost_column(const uint8_t mask[], int x);
+void free_puzzle(Puzzle_t *puzzle);
+
+// ------------------------------------------------------------BOOK------------------------------------------------------------
+int run_build_book(const char *path, int depth, int threads);
+uint32_t expand_book_level(BookLevel_t *level, int threads);
+void *expand_book_nodes(void *arg);
+void expand_book_node(const BookKey_t *node, BookEntry_t entries[],
+                      BookKey_t children[]);
+uint32_t unique_book_keys(void *keys, uint32_t count, size_t size);
+int compare_book_keys(const void *first, const void *second);
+bool write_book(const char *path, BookEntry_t *entries, uint32_t count);
+bool build_book_table(const BookEntry_t *entries, uint32_t count,
+                      uint32_t buckets, uint32_t slots,
+                      uint32_t displacements[], BookEntry_t table[]);
+int compare_book_buckets(const void *first, const void *second);
+bool place_book_bucket(const BookEntry_t *entries, const BookBucket_t *bucket,
+                       uint32_t displacement, uint32_t slots,
+                       BookEntry_t table[]);
+bool book_open(const char *path);
+void book_close();
+bool book_lookup(const BookKey_t *key, Placement_t *placement);
+bool book_placement(GameInfo_t *game, Placement_t *placement);
+
+// ------------------------------------------------------------SAVE------------------------------------------------------------
+bool save_game(GameInfo_t *game, const char *path);
+bool load_game(GameInfo_t *game, const char *path);
+bool restore_game(GameInfo_t *game, const uint8_t *data);
+void serialize_game(GameInfo_t *game, uint8_t *payload);
+bool deserialize_game(GameInfo_t *game, const uint8_t *payload);
+void pack_field(GameInfo_t *game, uint8_t packed[]);
+bool unpack_field(const uint8_t packed[], GameInfo_t *game);
+uint16_t shape_to_bits(int shape[SHAPE_SIZE][SHAPE_SIZE]);
+void bits_to_shape(uint16_t bits, int shape[SHAPE_SIZE][SHAPE_SIZE]);
+void put_bytes(uint8_t **cursor, const void *value, size_t size);
+void get_bytes(const uint8_t **cursor, void *value, size_t size);
+uint32_t crc32(const uint8_t *data, size_t size);
+
 #endif  // TETRIS_H
@@ -0,0 +1,114 @@
+#include "tetris.h"
+
+bool trace_enabled = false;
+
+static const char *trace_path = NULL;
+static uint64_t trace_origin = 0;
+static _Atomic(TraceBuffer_t *) trace_buffers = NULL;
+static atomic_int trace_threads = 0;
+static _Thread_local TraceBuffer_t *trace_buffer = NULL;
+
+void trace_start(const char *path) {
+  trace_path = path;
+  trace_origin = monotonic_time();
+  trace_enabled = true;
+  add_event_handler(trace_game_event, NULL);
+}
+
+void trace_event(const char *name, char phase) {
+  if (trace_buffer == NULL) {
+    trace_buffer = register_trace_buffer();
+  }
+
+  TraceBuffer_t *buffer = trace_buffer;
+
+  if (buffer == NULL || buffer->count == TRACE_CAPACITY) {
+    if (buffer != NULL) buffer->dropped++;
+    return;
+  }
+
+  TraceEvent_t *event = &buffer->events[buffer->count++];
+  event->name = name;
+  event->phase = phase;
+  event->timestamp = trace_now();
+}
+
+TraceBuffer_t *register_trace_buffer() {
+  TraceBuffer_t *buffer = (TraceBuffer_t *)calloc(1, sizeof(TraceBuffer_t));
+
+  if (buffer != NULL) {
+    buffer->events =
+        (TraceEvent_t *)malloc(TRACE_CAPACITY * sizeof(TraceEvent_t));
+
+    if (buffer->events == NULL) {
+      free(buffer);
+      return NULL;
+    }
+
+    buffer->thread_id = atomic_fetch_add(&trace_threads, 1) + 1;
+    buffer->next = atomic_load(&trace_buffers);
+    while (!atomic_compare_exchange_weak(&trace_buffers, &buffer->next,
+                                         buffer)) {
+    }
+  }
+
+  return buffer;
+}
+
+uint64_t trace_now() { return monotonic_time() - trace_origin; }
+
+void trace_stop() {
+  if (!trace_enabled) return;
+
+  trace_enabled = false;
+  write_trace(trace_path);
+
+  TraceBuffer_t *buffer = atomic_exchange(&trace_buffers, NULL);
+  while (buffer != NULL) {
+    TraceBuffer_t *next = buffer->next;
+    free(buffer->events);
+    free(buffer);
+    buffer = next;
+  }
+
+  trace_buffer = NULL;
+}
+
+void write_trace(const char *path) {
+  FILE *trace_file = fopen(path, "w");
+
+  if (trace_file != NULL) {
+    bool first = true;
+    fprintf(trace_file, "{\"traceEvents\":[");
+
+    for (TraceBuffer_t *buffer = atomic_load(&trace_buffers); buffer != NULL;
+         buffer = buffer->next) {
+      write_trace_buffer(trace_file, buffer, &first);
+    }
+
+    fprintf(trace_file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(trace_file);
+  }
+}
+
+void write_trace_buffer(FILE *trace_file, TraceBuffer_t *buffer, bool *first) {
+  for (size_t i = 0; i < buffer->count; i++) {
+    TraceEvent_t *event = &buffer->events[i];
+
+    fprintf(trace_file,
+            "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,"
+            "\"tid\":%d}",
+            *first ? "" : ",", event->name, event->phase,
+            event->timestamp / 1000.0, buffer->thread_id);
+    *first = false;
+  }
+
+  if (buffer->dropped > 0) {
+    fprintf(trace_file,
+            "%s\n{\"name\":\"dropped_events\",\"ph\":\"i\",\"s\":\"t\","
+            "\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"count\":%lu}}",
+            *first ? "" : ",", trace_now() / 1000.0, buffer->thread_id,
+            (unsigned long)buffer->dropped);
+    *first = false;
+  }
+}
@@ -0,0 +1,20 @@
+#include "tetris.h"
+
+void run_workers(void *(*work)(void *), void *argument, int threads) {
+  pthread_t workers[WORKERS_MAX_THREADS];
+
+  if (threads > WORKERS_MAX_THREADS) threads = WORKERS_MAX_THREADS;
+
+  int started = 0;
+  for (int i = 0; i < threads; i++) {
+    if (pthread_create(&workers[started], NULL, work, argument) == 0) {
+      started++;
+    }
+  }
+
+  if (started == 0) work(argument);
+
+  for (int i = 0; i < started; i++) {
+    pthread_join(workers[i], NULL);
+  }
+}
@@ -8,28 +8,85 @@ void init_ncurses() {
   scrollok(stdscr, TRUE);
   curs_set(0);
   keypad(stdscr, TRUE);
+  init_colors();
+}
+
+void init_colors() {
+  if (!has_colors()) return;
+
+  short colors[] = {COLOR_YELLOW, COLOR_CYAN,  COLOR_MAGENTA, COLOR_WHITE,
+                    COLOR_BLUE,   COLOR_RED,   COLOR_GREEN};
+
+  start_color();
+  for (int i = 0; i < (int)LEN(colors); i++) {
+    init_pair((short)(i + 1), colors[i], colors[i]);
+    init_pair((short)(i + 1 + LEN(colors)), colors[i], COLOR_BLACK);
+  }
+}
+
+chtype cell_symbol(Cell_t cell) {
+  if (cell == EMPTY_CELL) return SPACE;
+
+  return BLOCK | (has_colors() ? COLOR_PAIR(cell) : 0);
+}
+
+void print_border(int top, int left, int height, int width) {
+  for (int column = 0; column < width; column++) {
+    mvaddch(top, left + column, H_LINE);
+    mvaddch(top + height - 1, left + column, H_LINE);
+  }
+
+  for (int row = 1; row < height - 1; row++) {
+    mvaddch(top + row, left, V_LINE);
+    mvaddch(top + row, left + width - 1, V_LINE);
+  }
 }
 
 void print_game(GameInfo_t *game) {
-  clear();
+  TRACE_BEGIN("print_game");
+
+  TRACE_BEGIN("erase");
+  erase();
+  TRACE_END("erase");
 
+  TRACE_BEGIN("print_field");
   print_field(game);
+  TRACE_END("print_field");
+
+  TRACE_BEGIN("print_high_score");
   print_high_score(game);
+  TRACE_END("print_high_score");
+
+  TRACE_BEGIN("print_score");
   print_score(game);
+  TRACE_END("print_score");
+
+  TRACE_BEGIN("print_level");
   print_level(game);
+  TRACE_END("print_level");
+
+  TRACE_BEGIN("print_next_field");
   print_next_field(game);
+  TRACE_END("print_next_field");
+
+  TRACE_BEGIN("print_menu");
   print_menu(game);
+  TRACE_END("print_menu");
 
+  TRACE_BEGIN("refresh");
   refresh();
-  napms(game->speed);
+  TRACE_END("refresh");
+
+  TRACE_END("print_game");
 }
 
 void print_field(GameInfo_t *game) {
-  for (int row = 0; row < FIELD_HEIGHT; row++) {
-    for (int column = 0; column < FIELD_WIDTH; column++) {
-      printw("%c", game->field[row][column]);
+  print_border(0, 0, FIELD_HEIGHT, FIELD_WIDTH);
+
+  for (int row = 0; row < BOARD_HEIGHT; row++) {
+    for (int column = 0; column < BOARD_WIDTH; column++) {
+      mvaddch(row + 1, column + 1, cell_symbol(game->field[row][column]));
     }
-    printw("\n");
   }
 }
 
@@ -70,7 +127,7 @@ void print_level(GameInfo_t *game) {
   int caption_y = 7;
   mvprintw(caption_y, caption_x, "LEVEL\n");
 
-  int number_x = (game->level == 10) ? 16 : 17;
+  int number_x = (game->level >= 10) ? 16 : 17;
   int number_y = 8;
   mvprintw(number_y, number_x, "%d\n", game->level);
 }
@@ -80,12 +137,14 @@ void print_next_field(GameInfo_t *game) {
   int caption_y = 10;
   mvprintw(caption_y, caption_x, "NEXT\n");
 
-  for (int row = 0; row < NEXT_HEIGHT; row++) {
-    for (int column = 0; column < NEXT_WIDTH; column++) {
-      mvprintw((NEXT_FIRST_V_BORDER + row), (NEXT_FIRST_H_BORDER + column),
-               "%c", (char)game->next[row][column]);
+  print_border(NEXT_FIRST_V_BORDER, NEXT_FIRST_H_BORDER, NEXT_HEIGHT,
+               NEXT_WIDTH);
+
+  for (int row = 0; row < SHAPE_SIZE; row++) {
+    for (int column = 0; column < SHAPE_SIZE; column++) {
+      mvaddch(NEXT_FIRST_V_BORDER + row + 1, NEXT_FIRST_H_BORDER + column + 1,
+              cell_symbol(game->next[row][column]));
     }
-    printw("\n");
   }
 }
 
@@ -0,0 +1,148 @@
+#include "../../brick_game/tetris/tetris.h"
+
+int run_dashboard(int count) {
+  static DashboardBoard_t boards[DASHBOARD_MAX_BOARDS];
+  uint64_t frame = 1000000000ULL / DASHBOARD_FPS;
+  unsigned int seed = 0;
+
+  if (count > DASHBOARD_MAX_BOARDS) count = DASHBOARD_MAX_BOARDS;
+
+  for (int i = 0; i < count; i++) {
+    start_dashboard_game(&boards[i], ++seed);
+  }
+
+  init_ncurses();
+
+  uint64_t next_frame = monotonic_time();
+  uint64_t second = next_frame;
+  long frames = 0;
+  long second_frames = 0;
+  double fps = 0;
+  int key = ERR;
+
+  while (key != 'q') {
+    uint64_t now = monotonic_time();
+    int columns = COLS / DASHBOARD_TILE_WIDTH;
+    if (columns < 1) columns = 1;
+
+    TRACE_BEGIN("dashboard_frame");
+    for (int i = 0; i < count; i++) {
+      if (step_dashboard_board(&boards[i], now)) {
+        start_dashboard_game(&boards[i], ++seed);
+      }
+
+      int top = 1 + (i / columns) * DASHBOARD_TILE_HEIGHT;
+      int left = (i % columns) * DASHBOARD_TILE_WIDTH;
+
+      if (top + DASHBOARD_TILE_HEIGHT <= LINES &&
+          dashboard_board_changed(&boards[i])) {
+        print_dashboard_board(&boards[i], top, left);
+      }
+    }
+
+    frames++;
+    second_frames++;
+    if (now - second >= 1000000000ULL) {
+      fps = second_frames * 1e9 / (now - second);
+      second = now;
+      second_frames = 0;
+    }
+    print_dashboard_status(count, frames, fps);
+
+    TRACE_BEGIN("refresh");
+    refresh();
+    TRACE_END("refresh");
+    TRACE_END("dashboard_frame");
+
+    key = getch();
+    if (key == KEY_RESIZE) {
+      erase();
+      for (int i = 0; i < count; i++) boards[i].drawn = false;
+    }
+
+    next_frame += frame;
+    if (next_frame < now) next_frame = now;
+
+    struct timespec wake = {(time_t)(next_frame / 1000000000ULL),
+                            (long)(next_frame % 1000000000ULL)};
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+  }
+
+  endwin();
+
+  for (int i = 0; i < count; i++) {
+    finish_telemetry(&boards[i].game);
+  }
+
+  return 0;
+}
+
+void start_dashboard_game(DashboardBoard_t *board, unsigned int seed) {
+  prepare_game(&board->game, seed);
+  board->game.headless = 1;
+  begin_telemetry(&board->game);
+  start_bot(&board->bot);
+
+  board->due = monotonic_time();
+  board->games++;
+  board->drawn = false;
+}
+
+bool step_dashboard_board(DashboardBoard_t *board, uint64_t now) {
+  GameInfo_t *game = &board->game;
+
+  while (!game->exit && board->due <= now) {
+    update_state(game, bot_action(&board->bot, game));
+    board->changed = drain_events(game) > 0 || board->changed;
+
+    board->due += FRAME_TIME;
+  }
+
+  if (game->exit) finish_telemetry(game);
+
+  return game->exit;
+}
+
+bool dashboard_board_changed(DashboardBoard_t *board) {
+  bool changed = board->changed || !board->drawn;
+
+  board->changed = false;
+  board->drawn = true;
+
+  return changed;
+}
+
+void print_dashboard_board(DashboardBoard_t *board, int top, int left) {
+  GameInfo_t *game = &board->game;
+  char caption[DASHBOARD_TILE_WIDTH];
+
+  print_border(top, left, DASHBOARD_TILE_HEIGHT - 1, BOARD_WIDTH + 2);
+
+  for (int row = 0; row < BOARD_HEIGHT / 2; row++) {
+    for (int column = 0; column < BOARD_WIDTH; column++) {
+      mvaddch(top + row + 1, left + column + 1,
+              dashboard_cell_symbol(game->field[2 * row][column],
+                                    game->field[2 * row + 1][column]));
+    }
+  }
+
+  snprintf(caption, sizeof(caption), "%d L%d", game->score, game->level);
+  mvprintw(top + DASHBOARD_TILE_HEIGHT - 1, left, "%-*s", BOARD_WIDTH + 2,
+           caption);
+}
+
+chtype dashboard_cell_symbol(Cell_t upper, Cell_t lower) {
+  if (upper != EMPTY_CELL && lower != EMPTY_CELL) return cell_symbol(lower);
+  if (upper == EMPTY_CELL && lower == EMPTY_CELL) return SPACE;
+
+  Cell_t cell = (upper != EMPTY_CELL) ? upper : lower;
+  chtype symbol = (upper != EMPTY_CELL) ? '"' : '.';
+
+  return symbol | (has_colors() ? COLOR_PAIR(cell + LEN(figures)) : 0);
+}
+
+void print_dashboard_status(int count, long frames, double fps) {
+  mvprintw(0, 0, "%d boards, frame %ld, %.1f fps, q - quit", count, frames,
+           fps);
+  clrtoeol();
+}
@@ -1,7 +1,59 @@
 #include "brick_game/tetris/tetris.h"
 
-int main() {
-  tetris();
+int main(int argc, char *argv[]) {
+  double soak_hours = 0;
+  const char *puzzle_path = NULL;
+  int threads = 0;
+  int dashboard = 0;
+  const char *book_path = BOOK_FILE;
+  const char *build_book_path = NULL;
+  int book_depth = BOOK_DEPTH;
 
-  return 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      trace_start(argv[++i]);
+    } else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+      telemetry_start(open(argv[++i], O_WRONLY | O_CREAT | O_TRUNC, 0644));
+    } else if (strcmp(argv[i], "--telemetry-fd") == 0 && i + 1 < argc) {
+      telemetry_start(atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc) {
+      soak_hours = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--puzzle") == 0 && i + 1 < argc) {
+      puzzle_path = argv[++i];
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--dashboard") == 0 && i + 1 < argc) {
+      dashboard = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc) {
+      book_path = argv[++i];
+    } else if (strcmp(argv[i], "--build-book") == 0 && i + 1 < argc) {
+      build_book_path = argv[++i];
+    } else if (strcmp(argv[i], "--book-depth") == 0 && i + 1 < argc) {
+      book_depth = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--no-save") == 0) {
+      save_enabled = false;
+    }
+  }
+
+  int status = 0;
+
+  if (build_book_path == NULL) book_open(book_path);
+
+  if (build_book_path != NULL) {
+    status = run_build_book(build_book_path, book_depth, threads);
+  } else if (puzzle_path != NULL) {
+    status = run_puzzle(puzzle_path, threads);
+  } else if (dashboard > 0) {
+    status = run_dashboard(dashboard);
+  } else if (soak_hours > 0) {
+    status = run_soak(soak_hours);
+  } else {
+    tetris();
+  }
+
+  book_close();
+  telemetry_stop();
+  trace_stop();
+
+  return status;
 }